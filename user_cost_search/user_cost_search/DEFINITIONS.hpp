@@ -11,14 +11,20 @@
 #define PROBLEM_FILE "data/problem_data.txt"
 #define USER_COST_FILE "data/user_cost_data.txt"
 #define ASSIGNMENT_FILE "data/assignment_data.txt"
+#define SNAPSHOT_FILE "data/snapshot.bin"
 
 // Output file names
 #define FINAL_SOLUTION_FILE "log/final.txt"
+#define SOLUTION_LOG_FILE "log/solution_log.txt"
+#define CHECKPOINT_FILE "log/checkpoint.bin"
 
 // Exit codes
 #define SUCCESSFUL_EXIT 0
 #define FILE_NOT_FOUND 2
 #define INCORRECT_FILE 3
+#define WRITE_FAILED 4
+#define INCORRECT_OPTION 5
+#define SEARCH_INTERRUPTED 6
 
 // Node and arc type IDs
 #define STOP_NODE 0
@@ -44,7 +50,48 @@
 
 // Fixed parameters
 #define UC_COMPONENTS 3 // number of components of the user cost vector
+#define USER_COST_ROWS 6 // number of rows required in the user cost data file
+#define ASSIGNMENT_ROWS 7 // number of rows required in the assignment data file
 #define DELIMITER '_' // delimiter to use for defining solution log names
+#define DEFAULT_THREADS 0 // default number of worker threads (0 for one per hardware thread)
+#define SNAPSHOT_VERSION 1 // version of the data snapshot format (increase whenever the format changes)
+#define CHECKPOINT_VERSION 1 // version of the search checkpoint format (increase whenever the format changes)
+#define CHECKPOINT_INTERVAL 60.0 // smallest number of seconds between periodic search checkpoints
+#define TSV_MIN_CHUNK 1048576 // minimum size in bytes of each chunk of a data file parsed in parallel
+#define TSV_CHUNKS_PER_WORKER 4 // maximum number of chunks per worker into which a data file is divided
+
+// Label setting queue structures (select with ARC_QUEUE at compile time)
+#define ARC_QUEUE_LAZY 0 // binary heap with lazy deletion
+#define ARC_QUEUE_INDEXED 1 // indexed d-ary heap with decrease-key
+#ifndef ARC_QUEUE
+#define ARC_QUEUE ARC_QUEUE_INDEXED
+#endif
+#ifndef ARC_QUEUE_ARITY
+#define ARC_QUEUE_ARITY 4 // branching factor of the indexed heap
+#endif
+
+// Frank-Wolfe step size and direction rules (selected in the assignment data file)
+#define STEP_MSA 0 // method of successive averages
+#define STEP_LINE_SEARCH 1 // exact line search by bisection on the directional derivative
+#define DIRECTION_FW 0 // standard Frank-Wolfe direction
+#define DIRECTION_CONJUGATE 1 // conjugate Frank-Wolfe direction (requires the exact line search)
+#define LINE_SEARCH_TOL 0.000001 // width of the step size interval at which bisection stops
+#define CONJUGATE_DELTA 0.01 // minimum weight given to the newest constant-cost solution by the conjugate direction
+#define UPDATE_BLOCK 256 // number of arcs handled at a time by the combined Frank-Wolfe update pass
+
+
+// Instrumentation level (select with INSTRUMENT at compile time, see instrumentation.hpp)
+#define INSTRUMENT_OFF 0 // no instrumentation
+#define INSTRUMENT_COUNTERS 1 // event counters and phase timers
+#define INSTRUMENT_HARDWARE 2 // event counters, phase timers, and hardware performance counters
+#ifndef INSTRUMENT
+#define INSTRUMENT INSTRUMENT_OFF
+#endif
+
+// Trace recorder switch (set to 1 to record a timeline of worker activity, see trace.hpp)
+#ifndef TRACE
+#define TRACE 0
+#endif
 
 // Other technical definitions
 #define EPSILON 0.00000001 // very small positive value
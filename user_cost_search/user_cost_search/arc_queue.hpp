@@ -0,0 +1,233 @@
+/**
+Priority queues of arcs for the label setting algorithm.
+
+The label setting algorithm repeatedly removes the unprocessed arc with the smallest cost-plus-head-label value, while updating the values of arcs whose heads receive new labels. Two interchangeable queue structures are provided so that they can be benchmarked against each other, and the one used by the assignment model is chosen at compile time by the ARC_QUEUE definition.
+
+Both queues order arcs by value and break ties by arc ID, so they remove arcs in exactly the same order and give identical assignment results.
+
+The queue methods are defined in this header so that they can be inlined into the label setting loop.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "DEFINITIONS.hpp"
+
+using namespace std;
+
+typedef pair<double, int> arc_cost_pair; // used to define a priority queue of combined cost/ID pairs sorted by the first element
+
+// Structure declarations
+struct LazyArcQueue;
+struct IndexedArcQueue;
+
+/**
+Binary heap with lazy deletion.
+
+Updating an arc's value simply adds another copy of the arc to the heap, so the heap may contain several copies of the same arc. Only the first copy removed has the arc's current value, and the caller is responsible for ignoring later copies.
+*/
+struct LazyArcQueue
+{
+	// Public attributes
+	vector<arc_cost_pair> heap; // min-heap of value/arc ID pairs
+
+	// Public methods
+	LazyArcQueue(int); // constructor reserves space for a given number of arcs
+	void reset(); // removes all arcs
+	bool empty(); // returns whether the queue is empty
+	void push(double, int); // adds a copy of an arc with a given value
+	arc_cost_pair pop(); // removes and returns the value/arc ID pair with the smallest value
+	size_t memory(); // returns the number of bytes reserved by the queue
+};
+
+/**
+Indexed d-ary heap with decrease-key.
+
+Each arc appears in the heap at most once, and the heap position of every arc is tracked so that its value can be decreased in place. The heap size is therefore bounded by the number of arcs. The branching factor is set by the ARC_QUEUE_ARITY definition, with higher values giving shallower heaps at the cost of more comparisons per level.
+*/
+struct IndexedArcQueue
+{
+	// Public attributes
+	vector<double> keys; // value of the arc at each heap position
+	vector<int> arcs; // arc ID at each heap position
+	vector<int> position; // heap position of each arc (-1 if not in the heap)
+
+	// Public methods
+	IndexedArcQueue(int); // constructor sizes the position list for a given number of arcs
+	void reset(); // removes all arcs
+	bool empty(); // returns whether the queue is empty
+	void push(double, int); // adds an arc with a given value, or decreases its value if it is already in the heap
+	arc_cost_pair pop(); // removes and returns the value/arc ID pair with the smallest value
+	size_t memory(); // returns the number of bytes reserved by the queue
+	bool before(int, int); // returns whether the entry at one heap position comes before the entry at another
+	void place(int, double, int); // writes an entry into a heap position and records the arc's position
+	void sift_up(int, double, int); // moves an entry up from a given heap position to its correct place
+	void sift_down(int, double, int); // moves an entry down from a given heap position to its correct place
+};
+
+// Queue structure used by the assignment model
+#if ARC_QUEUE == ARC_QUEUE_LAZY
+typedef LazyArcQueue ArcQueue;
+#else
+typedef IndexedArcQueue ArcQueue;
+#endif
+
+/// Lazy queue constructor reserves space for one copy of every arc.
+inline LazyArcQueue::LazyArcQueue(int arc_count)
+{
+	heap.reserve(arc_count);
+}
+
+/// Removes all arcs from the lazy queue without releasing memory.
+inline void LazyArcQueue::reset()
+{
+	heap.clear();
+}
+
+/// Returns whether the lazy queue is empty.
+inline bool LazyArcQueue::empty()
+{
+	return heap.empty();
+}
+
+/// Adds a new copy of an arc to the lazy queue.
+inline void LazyArcQueue::push(double key, int arc)
+{
+	heap.push_back(make_pair(key, arc));
+	push_heap(heap.begin(), heap.end(), greater<arc_cost_pair>());
+}
+
+/// Removes and returns the smallest value/arc ID pair of the lazy queue.
+inline arc_cost_pair LazyArcQueue::pop()
+{
+	pop_heap(heap.begin(), heap.end(), greater<arc_cost_pair>());
+	arc_cost_pair top = heap.back();
+	heap.pop_back();
+	return top;
+}
+
+/// Returns the number of bytes reserved by the lazy queue.
+inline size_t LazyArcQueue::memory()
+{
+	return heap.capacity() * sizeof(arc_cost_pair);
+}
+
+/// Indexed queue constructor marks every arc as absent from the heap and reserves space for all arcs.
+inline IndexedArcQueue::IndexedArcQueue(int arc_count)
+{
+	keys.reserve(arc_count);
+	arcs.reserve(arc_count);
+	position.resize(arc_count, NO_ID);
+}
+
+/// Removes all arcs from the indexed queue, which only requires resetting the positions of the arcs left in the heap.
+inline void IndexedArcQueue::reset()
+{
+	for (int i = 0; i < arcs.size(); i++)
+		position[arcs[i]] = NO_ID;
+	keys.clear();
+	arcs.clear();
+}
+
+/// Returns whether the indexed queue is empty.
+inline bool IndexedArcQueue::empty()
+{
+	return arcs.empty();
+}
+
+/// Adds an arc to the indexed queue, or decreases its value if it is already present with a larger value.
+inline void IndexedArcQueue::push(double key, int arc)
+{
+	int i = position[arc];
+
+	if (i == NO_ID)
+	{
+		// New arc goes at the bottom of the heap
+		keys.push_back(key);
+		arcs.push_back(arc);
+		sift_up(keys.size() - 1, key, arc);
+	}
+	else if (key < keys[i])
+		// Existing arc has its value decreased in place
+		sift_up(i, key, arc);
+}
+
+/// Removes and returns the smallest value/arc ID pair of the indexed queue.
+inline arc_cost_pair IndexedArcQueue::pop()
+{
+	arc_cost_pair top = make_pair(keys[0], arcs[0]);
+	position[arcs[0]] = NO_ID;
+
+	// Move the last entry to the root and restore the heap order
+	double last_key = keys.back();
+	int last_arc = arcs.back();
+	keys.pop_back();
+	arcs.pop_back();
+	if (arcs.empty() == false)
+		sift_down(0, last_key, last_arc);
+
+	return top;
+}
+
+/// Returns the number of bytes reserved by the indexed queue.
+inline size_t IndexedArcQueue::memory()
+{
+	return keys.capacity() * sizeof(double) + (arcs.capacity() + position.capacity()) * sizeof(int);
+}
+
+/// Returns whether the entry at heap position i comes before the entry at heap position j, comparing values and then arc IDs.
+inline bool IndexedArcQueue::before(int i, int j)
+{
+	return (keys[i] < keys[j]) || ((keys[i] == keys[j]) && (arcs[i] < arcs[j]));
+}
+
+/// Writes a value/arc ID entry into a heap position and records the arc's new position.
+inline void IndexedArcQueue::place(int i, double key, int arc)
+{
+	keys[i] = key;
+	arcs[i] = arc;
+	position[arc] = i;
+}
+
+/// Moves an entry up from heap position i, shifting larger parents down until its correct position is found.
+inline void IndexedArcQueue::sift_up(int i, double key, int arc)
+{
+	while (i > 0)
+	{
+		int parent = (i - 1) / ARC_QUEUE_ARITY;
+		if ((keys[parent] < key) || ((keys[parent] == key) && (arcs[parent] < arc)))
+			break;
+		place(i, keys[parent], arcs[parent]);
+		i = parent;
+	}
+	place(i, key, arc);
+}
+
+/// Moves an entry down from heap position i, shifting smaller children up until its correct position is found.
+inline void IndexedArcQueue::sift_down(int i, double key, int arc)
+{
+	int size = arcs.size();
+
+	while (true)
+	{
+		// Find the smallest child
+		int first = ARC_QUEUE_ARITY * i + 1;
+		if (first >= size)
+			break;
+		int best = first;
+		int last = min(first + ARC_QUEUE_ARITY, size);
+		for (int c = first + 1; c < last; c++)
+			if (before(c, best) == true)
+				best = c;
+
+		// Stop once the entry is no larger than its smallest child
+		if ((key < keys[best]) || ((key == keys[best]) && (arc < arcs[best])))
+			break;
+		place(i, keys[best], arcs[best]);
+		i = best;
+	}
+	place(i, key, arc);
+}
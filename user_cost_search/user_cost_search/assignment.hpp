@@ -6,31 +6,65 @@ Solves the Spiess and Florian model to return the user flows based on a given so
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <sstream>
 #include <stack>
 #include <string>
-#include <ppl.h>
 #include <queue>
 #include <string>
 #include <utility>
 #include <unordered_set>
 #include <vector>
 #include "DEFINITIONS.hpp"
+#include "arc_queue.hpp"
+#include "conical_kernel.hpp"
+#include "instrumentation.hpp"
 #include "network.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 using namespace std;
-using namespace concurrency;
 
-extern string FILE_BASE;
+extern thread_local string FILE_BASE;
 
-typedef pair<double, int> arc_cost_pair; // used to define a priority queue of combined cost/ID pairs sorted by the first element
+typedef pair<vector<double>, double> flow_pair; // flow vector/waiting time pair making up an assignment model solution
 
 // Structure declarations
+struct Workspace;
 struct ConstantAssignment;
 struct NonlinearAssignment;
 
+/**
+Reusable scratch space for the single-destination label setting algorithm.
+
+Each worker thread owns one workspace, which is sized once for the network and reused for every destination that it processes, so that the assignment model allocates no memory in its inner loop. Instead of clearing the arc flags between destinations, each label setting pass is given a new number and flags are stamped with the number of the pass that set them.
+*/
+struct Workspace
+{
+	// Public attributes
+	vector<double> node_label; // tentative distance from each node to the destination
+	vector<double> node_freq; // total frequency of all attractive arcs leaving each node
+	vector<double> node_vol; // total flow leaving each node
+	vector<double> node_wait; // expected waiting time at each node
+	ArcQueue arc_queue; // priority queue of cost-plus-head-label/arc ID pairs
+	vector<unsigned int> processed; // number of the last pass in which each arc was processed
+	vector<unsigned int> attractive; // number of the last pass in which each arc was attractive
+	vector<int> order; // arcs added to the attractive set during the current pass, in the order they were chosen
+	unsigned int pass = 0; // number of the current pass
+
+	// Public methods
+	Workspace(int, int); // constructor sizes the node and arc arrays for a given number of nodes and arcs
+	void reset(); // begins a new pass, restoring the node arrays and marking all arcs unprocessed and unattractive
+	size_t memory(); // returns the number of bytes reserved by the workspace
+};
+
 /**
 Constant-cost assignment model class.
 
@@ -43,11 +77,23 @@ struct ConstantAssignment
 	// Public attributes
 	Network * Net; // pointer to network object
 	int stop_size; // number of stop nodes in network
+	vector<double> dest_cost; // estimated relative cost of each single-destination subproblem, in the same order as the stop node list
+	vector<int> dest_order; // stop node list positions of all destinations with nonzero demand, sorted from heaviest to lightest estimated cost
+	vector<Workspace *> workspaces; // scratch space for each worker
+	vector<flow_pair *> spare_buffers; // recycled zeroed flow/waiting buffers used to sum single-destination results
+	mutex buffer_lock; // lock for the spare buffer list
+
 
 	// Public methods
-	ConstantAssignment(Network *); // constructor sets network pointer
+	ConstantAssignment(Network *); // constructor sets network pointer, creates workspaces, and schedules destinations
+	~ConstantAssignment(); // destructor deletes workspaces and spare flow buffers
 	pair<vector<double>, double> calculate(const vector<int> &, const vector<double> &); // calculates flow vector for a given fleet vector and arc cost vector
-	void flows_to_destination(int, vector<double> &, double &, const vector<double> &, const vector<double> &, reader_writer_lock *, reader_writer_lock *); // calculates flow vector and waiting time for a single given sink
+	void flows_to_destination(int, vector<double> &, double &, const vector<double> &, const vector<double> &, Workspace *); // calculates flow vector and waiting time for a single given sink
+	void load_flows(int, vector<double> &, double &, const vector<double> &, Workspace *); // loads a single sink's demand onto the attractive arcs stored in a workspace
+	flow_pair * get_buffer(); // returns a zeroed flow/waiting buffer
+	void release_buffer(flow_pair *); // zeroes a flow/waiting buffer and recycles it
+	void report_memory(); // prints the memory reserved by each worker's workspace and by the flow buffers
+	void schedule_destinations(); // estimates single-destination subproblem costs and sorts destinations from heaviest to lightest
 };
 
 /**
@@ -56,6 +102,8 @@ Nonlinear cost assignment model class.
 Includes a variety of attributes and methods for evaluating the nonlinear cost version of the Spiess and Florian model.
 
 This model is evaluated by conducting the Frank-Wolfe algorithm on a nonlinear program. Each iteration requires solving the constant-cost version. The process halts either after an optimality bound cutoff or an iteration cutoff.
+
+The step size can be chosen either by the method of successive averages or by an exact line search, and the search direction can be either the standard Frank-Wolfe direction or a conjugate direction. Both choices are read from the assignment data file.
 */
 struct NonlinearAssignment
 {
@@ -68,12 +116,20 @@ struct NonlinearAssignment
 	int max_iterations; // iteration cutoff for Frank-Wolfe
 	double conical_alpha; // alpha parameter for conical congestion function
 	double conical_beta; // beta parameter for conical congestion function
+	int step_rule = STEP_MSA; // Frank-Wolfe step size rule
+	int direction_rule = DIRECTION_FW; // Frank-Wolfe search direction rule
 
 	// Public methods
-	NonlinearAssignment(Network *); // constructor reads assignment model data file and sets network pointer
+	NonlinearAssignment(Network *); // constructor reads assignment model parameters and sets network pointer
 	~NonlinearAssignment(); // destructor deletes constant-cost submodel
-	pair<vector<double>, double> calculate(const vector<int> &, const pair<vector<double>, double> &); // calculates flow vector for a given fleet vector and initial assignment model solution
+	static bool parameters_valid(const vector<double> &, ostream & = cout); // checks that the assignment data contain every required parameter and only recognized rules, describing any problems on a given stream
+	pair<vector<double>, double> calculate(const vector<int> &, const pair<vector<double>, double> &, int &); // calculates flow vector for a given fleet vector and initial assignment model solution, and outputs the number of Frank-Wolfe iterations
 	double arc_cost(int, double, double); // calculates the nonlinear cost function for a given arc
+	void update_costs(const vector<double> &, const vector<double> &, vector<double> &); // calculates the nonlinear cost function for all arcs
+	double arc_cost_derivative(int, double, double); // calculates the derivative of the nonlinear cost function for a given arc
 	double obj_error(const vector<double> &, const vector<double> &, double, const vector<double> &, double); // calculates an error bound for the current objective value
-	pair<double, double> solution_update(double, vector<double> &, double &, const vector<double> &, double); // updates current solution as a convex combination of the previous and next solutions, and outputs the maximum elementwise difference
+	pair<double, double> solution_update(double, const vector<double> &, vector<double> &, double &, const vector<double> &, double, vector<double> &, double &); // updates current solution as a convex combination of the previous and next solutions, updates arc costs, and outputs the error bound and the maximum elementwise difference
+	double line_search(const vector<double> &, const vector<double> &, double, const vector<double> &, double); // finds the step size minimizing the objective between the current and next solutions
+	double directional_derivative(double, const vector<double> &, const vector<double> &, double, const vector<double> &, double); // calculates the objective's derivative along the search direction at a given step size
+	void conjugate_direction(const vector<double> &, const pair<vector<double>, double> &, pair<vector<double>, double> &, pair<vector<double>, double> &); // replaces the next solution with a point giving a conjugate search direction
 };
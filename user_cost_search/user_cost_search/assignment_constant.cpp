@@ -2,11 +2,152 @@
 
 #include "assignment.hpp"
 
-/// Constant-cost assignment constructor sets network pointer.
+/// Constant-cost assignment constructor sets network pointer, creates a workspace for each worker, and determines the order in which destinations are processed.
 ConstantAssignment::ConstantAssignment(Network * net_in)
 {
 	Net = net_in;
 	stop_size = Net->stop_nodes.size();
+	for (int i = 0; i < Pool->worker_count; i++)
+		workspaces.push_back(new Workspace(Net->core_nodes.size(), Net->core_arcs.size()));
+	schedule_destinations();
+}
+
+/// Constant-cost assignment destructor deletes all workspaces and spare flow buffers.
+ConstantAssignment::~ConstantAssignment()
+{
+	for (int i = 0; i < workspaces.size(); i++)
+		delete workspaces[i];
+
+	for (int i = 0; i < spare_buffers.size(); i++)
+		delete spare_buffers[i];
+}
+
+/**
+Estimates the cost of each single-destination subproblem and sorts the destinations from heaviest to lightest.
+
+The label setting algorithm processes every core arc whose head can reach the destination, and the loading pass is only needed for destinations with nonzero incoming demand, so the estimate is based on these two quantities. Dispatching the heaviest destinations first keeps the longest subproblems from being left for the end of each parallel batch. Destinations with no incoming demand receive no flow and no waiting time, so they are left out of the order entirely.
+
+The set of nodes which can reach a destination is found using the strongly connected components of the core network. All nodes in a component reach the same destinations, so the reachable arc count only needs to be found once per component.
+*/
+void ConstantAssignment::schedule_destinations()
+{
+	int node_count = Net->core_nodes.size();
+
+	// First pass of Kosaraju's algorithm: order core nodes by depth-first search finishing time
+	vector<int> finished; // core node IDs in order of finishing time
+	vector<bool> visited(node_count, false);
+	for (int root = 0; root < node_count; root++)
+	{
+		if (visited[root] == true)
+			continue;
+		visited[root] = true;
+		stack<pair<int, int>> dfs; // node ID/next outgoing arc index pairs
+		dfs.push(make_pair(root, 0));
+		while (dfs.empty() == false)
+		{
+			int u = dfs.top().first;
+			int i = dfs.top().second;
+			if (Net->out_start[u] + i < Net->out_start[u + 1])
+			{
+				dfs.top().second++;
+				int v = Net->arc_head[Net->out_arcs[Net->out_start[u] + i]];
+				if (visited[v] == false)
+				{
+					visited[v] = true;
+					dfs.push(make_pair(v, 0));
+				}
+			}
+			else
+			{
+				finished.push_back(u);
+				dfs.pop();
+			}
+		}
+	}
+
+	// Second pass: assign components by searching the reversed network in reverse finishing order
+	vector<int> component(node_count, NO_ID); // component ID of each core node
+	int component_count = 0;
+	for (int k = node_count - 1; k >= 0; k--)
+	{
+		int root = finished[k];
+		if (component[root] != NO_ID)
+			continue;
+		stack<int> dfs;
+		dfs.push(root);
+		component[root] = component_count;
+		while (dfs.empty() == false)
+		{
+			int u = dfs.top();
+			dfs.pop();
+			for (int i = Net->in_start[u]; i < Net->in_start[u + 1]; i++)
+			{
+				int v = Net->arc_tail[Net->in_arcs[i]];
+				if (component[v] == NO_ID)
+				{
+					component[v] = component_count;
+					dfs.push(v);
+				}
+			}
+		}
+		component_count++;
+	}
+
+	// Count the arcs entering each component and find the component predecessors
+	vector<double> component_arcs(component_count, 0.0); // number of core arcs whose head lies in each component
+	vector<vector<int>> component_in(component_count); // components with an arc into each component
+	for (int i = 0; i < Net->core_arcs.size(); i++)
+	{
+		int tail = component[Net->arc_tail[i]];
+		int head = component[Net->arc_head[i]];
+		component_arcs[head]++;
+		if (tail != head)
+			component_in[head].push_back(tail);
+	}
+
+	// Estimate the cost of each destination
+	vector<double> reach(component_count, -1.0); // number of arcs which can reach each component (-1 if not yet calculated)
+	dest_cost.resize(stop_size);
+	for (int d = 0; d < stop_size; d++)
+	{
+		int c = component[Net->stop_nodes[d]->id];
+
+		// Total the arc counts of all components which can reach the destination's component
+		if (reach[c] < 0)
+		{
+			reach[c] = 0.0;
+			vector<bool> found(component_count, false);
+			stack<int> unsearched;
+			unsearched.push(c);
+			found[c] = true;
+			while (unsearched.empty() == false)
+			{
+				int u = unsearched.top();
+				unsearched.pop();
+				reach[c] += component_arcs[u];
+				for (int i = 0; i < component_in[u].size(); i++)
+				{
+					if (found[component_in[u][i]] == false)
+					{
+						found[component_in[u][i]] = true;
+						unsearched.push(component_in[u][i]);
+					}
+				}
+			}
+		}
+
+		// Label setting requires a heap operation per reachable arc, while loading requires a pass over the attractive arcs
+		dest_cost[d] = reach[c] * log2(reach[c] + 2);
+		if (Net->stop_demand[d] > 0)
+			dest_cost[d] += reach[c];
+	}
+
+	// Sort destinations with nonzero demand by descending cost, breaking ties by stop list position
+	dest_order.clear();
+	for (int d = 0; d < stop_size; d++)
+		if (Net->stop_demand[d] > 0)
+			dest_order.push_back(d);
+	stable_sort(dest_order.begin(), dest_order.end(), [&](int a, int b) { return dest_cost[a] > dest_cost[b]; });
 }
 
 /**
@@ -16,10 +157,13 @@ Requires a fleet size vector and nonlinear cost vector.
 
 Returns a pair containing a vector of flow values and a waiting time scalar.
 
-This model comes from the linear program formulation of the common line problem, which can be solved using a Dijkstra-like label setting algorithm. This must be done separately for every sink node, but each of these problems is independent and may be parallelized. The final result is the sum of these individual results.
+This model comes from the linear program formulation of the common line problem, which can be solved using a Dijkstra-like label setting algorithm. This must be done separately for every sink node with nonzero incoming demand, but each of these problems is independent and may be parallelized. The final result is the sum of these individual results.
 */
 pair<vector<double>, double> ConstantAssignment::calculate(const vector<int> &fleet, const vector<double> &arc_costs)
 {
+	PROFILE_COUNT(COUNT_CONSTANT, 1);
+	PROFILE_SCOPE(constant_timer, TIME_CONSTANT);
+
 	// Generate a vector of line frequencies based on the fleet sizes
 	vector<double> line_freq(Net->lines.size());
 	for (int i = 0; i < line_freq.size(); i++)
@@ -27,88 +171,181 @@ pair<vector<double>, double> ConstantAssignment::calculate(const vector<int> &fl
 
 	// Use the line frequencies to generate arc frequencies
 	vector<double> freq(Net->core_arcs.size(), INFINITY);
-	for (int i = 0; i < Net->lines.size(); i++)
-		for (int j = 0; j < Net->lines[i]->boarding.size(); j++)
-			freq[Net->lines[i]->boarding[j]->id] = line_freq[i];
-
-	// Initialize reader/writer locks for incrementing the flow and waiting variables for each hyperpath in parallel
-	reader_writer_lock flow_lock; // reader/writer lock for arc flow variables
-	reader_writer_lock wait_lock; // reader/writer lock for total waiting time variable
-
-	// Solve single-destination model in parallel for all sinks and add all results
-	vector<double> flows(Net->core_arcs.size(), 0.0); // total flow vector over all destinations
-	double waiting = 0.0; // total waiting time over all destinations
-	parallel_for_each(Net->stop_nodes.begin(), Net->stop_nodes.end(), [&](Node * s)
+	for (int i = 0; i < Net->core_arcs.size(); i++)
+		if (Net->arc_type[i] == BOARDING_ARC)
+			freq[i] = line_freq[Net->arc_line[i]];
+
+	/*
+	Each destination's flows are written into their own zeroed buffer, and the buffers are then summed pairwise along a fixed binary tree whose leaves are the destinations in dispatch order. Whichever task finishes second at a tree node adds its sibling's buffer into its own and carries the sum up to the next level, while the first simply parks its buffer at the node. Adding two buffers is exact regardless of which one is added to which, so the result depends only on the shape of the tree and not on thread scheduling, which makes repeated runs bit-identical. Because destinations are dispatched roughly in tree order, only a few buffers are ever parked at once.
+	*/
+
+	// Find the starting position of each level of the reduction tree
+	vector<int> level_size; // number of nodes on each tree level, beginning with the leaves
+	vector<int> level_start; // position of each level's first sibling pair in the parked buffer list
+	int pair_count = 0;
+	int dest_count = dest_order.size();
+	for (int size = dest_count; size > 1; size = (size + 1) / 2)
+	{
+		level_size.push_back(size);
+		level_start.push_back(pair_count);
+		pair_count += (size + 1) / 2;
+	}
+	vector<atomic<flow_pair *>> parked(pair_count); // buffer parked by the first finished node of each sibling pair
+	for (int i = 0; i < pair_count; i++)
+		parked[i] = nullptr;
+	flow_pair * root = nullptr; // final sum of all buffers
+
+	// Solve single-destination model in parallel for all sinks, heaviest first, and sum all results
+	Pool->run(dest_count, [&](int task, int worker)
 	{
-		flows_to_destination(s->id, flows, waiting, freq, arc_costs, &flow_lock, &wait_lock);
+		flow_pair * sum = get_buffer();
+		flows_to_destination(dest_order[task], sum->first, sum->second, freq, arc_costs, workspaces[worker]);
+
+		// Climb the reduction tree until reaching the root or a node whose sibling has not yet finished
+		int position = task;
+		for (int level = 0; level < level_size.size(); level++)
+		{
+			if ((position ^ 1) < level_size[level])
+			{
+				flow_pair * other = parked[level_start[level] + position / 2].exchange(sum);
+				if (other == nullptr)
+					// Sibling is unfinished, and will carry this buffer up the tree
+					return;
+
+				// Add sibling's buffer into this one and recycle it
+				PROFILE_SCOPE(reduction_timer, TIME_REDUCTION);
+				TRACE_SCOPE(reduction_span, "reduction", level);
+				for (int i = 0; i < sum->first.size(); i++)
+					sum->first[i] += other->first[i];
+				sum->second += other->second;
+				release_buffer(other);
+			}
+			position /= 2;
+		}
+		root = sum;
 	});
 
-	return make_pair(flows, waiting);
+	// Move the final sum out of its buffer
+	pair<vector<double>, double> total(vector<double>(Net->core_arcs.size(), 0.0), 0.0);
+	if (root != nullptr)
+	{
+		total.swap(*root);
+		delete root;
+	}
+
+	return total;
+}
+
+/**
+Prints the memory reserved by each worker's workspace and by the shared flow buffers.
+
+The workspace heaps grow to fit the largest destination seen so far, so this is most informative after at least one full assignment.
+*/
+void ConstantAssignment::report_memory()
+{
+	cout << fixed << setprecision(3);
+	for (int i = 0; i < workspaces.size(); i++)
+		cout << "Worker " << i << " workspace: " << workspaces[i]->memory() / 1048576.0 << " MB" << endl;
+
+	size_t buffer_size = sizeof(flow_pair) + Net->core_arcs.size() * sizeof(double);
+	lock_guard<mutex> guard(buffer_lock);
+	cout << "Flow buffers: " << spare_buffers.size() << " x " << buffer_size / 1048576.0 << " MB" << endl;
+	cout.unsetf(ios_base::floatfield);
+	cout << setprecision(6);
+}
+
+/// Returns a zeroed flow vector/waiting time buffer, reusing a recycled buffer if one is available.
+flow_pair * ConstantAssignment::get_buffer()
+{
+	flow_pair * buffer = nullptr;
+	{
+		profiled_guard guard(buffer_lock);
+		if (spare_buffers.empty() == false)
+		{
+			buffer = spare_buffers.back();
+			spare_buffers.pop_back();
+		}
+	}
+
+	if (buffer == nullptr)
+		buffer = new flow_pair(vector<double>(Net->core_arcs.size(), 0.0), 0.0);
+
+	return buffer;
+}
+
+/// Zeroes a flow vector/waiting time buffer and returns it to the spare buffer list.
+void ConstantAssignment::release_buffer(flow_pair * buffer)
+{
+	fill(buffer->first.begin(), buffer->first.end(), 0.0);
+	buffer->second = 0.0;
+
+	profiled_guard guard(buffer_lock);
+	spare_buffers.push_back(buffer);
 }
 
 /**
 Calculates the flow vector to a given sink.
 
-Requires the sink index (as a position in the stop node list), flow vector, waiting time scalar, line frequency vector, arc cost vector, and pointers to the arc flow reader/writer lock and waiting time reader/writer lock, respectively.
+Requires the sink index (as a position in the stop node list), flow vector, waiting time scalar, line frequency vector, arc cost vector, and a pointer to the calling worker's workspace, respectively.
 
-The flow vector and waiting time are passed by reference and automatically incremented according to the results of this function.
+The flow vector and waiting time are passed by reference and automatically incremented according to the results of this function. Each call should be given its own flow vector and waiting time, since they are updated without locking.
 
-The algorithm here solves the constant-cost, single-destination version of the common lines problem, which is a LP similar to min-cost flow and is solvable with a Dijkstra-like label setting algorithm. This process can be parallelized over all destinations, and so should rely only on local variables.
+The algorithm here solves the constant-cost, single-destination version of the common lines problem, which is a LP similar to min-cost flow and is solvable with a Dijkstra-like label setting algorithm. This process can be parallelized over all destinations, and so should rely only on local variables and the worker's own workspace.
 */
-void ConstantAssignment::flows_to_destination(int dest, vector<double> &flows, double &waiting, const vector<double> &freq, const vector<double> &arc_costs, reader_writer_lock *flow_lock, reader_writer_lock *wait_lock)
+void ConstantAssignment::flows_to_destination(int dest, vector<double> &flows, double &waiting, const vector<double> &freq, const vector<double> &arc_costs, Workspace * work)
 {
 	/*
-	To explain a few technical details, the label setting algorithm involves updating a distance label for each node. In each iteration, we choose the unprocessed arc with the minimum value of its own cost plus its head's label. In order to speed up that search, we store all of those values in a min-priority queue. As with Dijkstra's algorithm, to get around the inability to update priorities, we just add extra copies to the queue whenever they are updated. We also store a master list of those values, which should always decrease as the algorithm moves forward, as a comparison every time we pop something out of the queue to ensure that we have the latest version.
+	To explain a few technical details, the label setting algorithm involves updating a distance label for each node. In each iteration, we choose the unprocessed arc with the minimum value of its own cost plus its head's label. In order to speed up that search, we store all of those values in a min-priority queue, whose structure is chosen at compile time (see arc_queue.hpp). Depending on the structure, an updated value either decreases the arc's existing key or adds an extra copy of the arc to the queue. In the latter case only the first copy of an arc to leave the queue is used, since later copies have outdated values, and so each arc is stamped in the workspace once it has been processed.
 
-	The arc loading algorithm involves processing all of the selected attractive arcs in descending order of their cost-plus-head-label from the label setting algorithm. This is accomplished in a similar way, with a copy of the cost-plus-head-label being added to a max-priority queue each time the tail label is updated.
+	The arc loading algorithm involves processing all of the selected attractive arcs in descending order of their cost-plus-head-label from the label setting algorithm. Since the label setting algorithm chooses arcs in ascending order of that same value, this is accomplished by recording the order in which attractive arcs are chosen and then replaying it backwards, skipping any arcs that were later removed from the attractive set.
 	*/
 
 	// Initialize variables
 	double chosen_label; // cost-plus-head-label value chosen for current loop iteration
 	int chosen_arc; // arc ID chosen for current loop iteration
 	int chosen_tail; // tail node ID chosen for current loop iteration
-	int chosen_head; // head node ID chosen for current loop iteration
 	int updated_arc; // arc ID for label setting updates
 	double updated_label; // updated label value
-	double added_flow; // chosen arc's added flow volume
 
-	// Initialize containers
-	vector<double> node_label(Net->core_nodes.size(), INFINITY); // tentative distances from every node to the destination
+	TRACE_SCOPE(destination_span, "destination", dest);
+	PROFILE_LOCAL(profile);
+	PROFILE_LOCAL_COUNT(profile, COUNT_DESTINATIONS, 1);
+	PROFILE_SCOPE(label_timer, TIME_LABEL);
+
+	// Initialize containers from the workspace, with all arcs initially unprocessed and unattractive
+	work->reset();
+	vector<double> &node_label = work->node_label; // tentative distances from every node to the destination
 	node_label[Net->stop_nodes[dest]->id] = 0.0; // distance from destination to self is 0
-	vector<double> node_freq(Net->core_nodes.size(), 0.0); // total frequency of all attractive arcs leaving a node
-	vector<double> node_vol(Net->core_nodes.size(), 0.0); // total flow leaving a node
-	for (int i = 0; i < Net->stop_nodes.size(); i++)
-		// Initialize travel volumes for stop nodes based on demand for destination
-		node_vol[Net->stop_nodes[i]->id] = Net->stop_nodes[dest]->incoming_demand[i];
-	vector<double> node_wait(Net->core_nodes.size(), 0.0); // expected waiting time at each node
-	unordered_set<int> unprocessed_arcs; // arcs not yet chosen in the main label setting loop, in order to ensure that each arc is processed only once
-	for (int i = 0; i < Net->core_arcs.size(); i++)
-		// All arcs are initially unprocessed
-		unprocessed_arcs.insert(Net->core_arcs[i]->id);
-	priority_queue<arc_cost_pair, vector<arc_cost_pair>, greater<arc_cost_pair>> arc_queue; // min-priority queue to quickly access the unprocessed arc with the minimum cost-plus-head-distance value
-	for (int i = 0; i < Net->stop_nodes[dest]->core_in.size(); i++)
+	vector<double> &node_freq = work->node_freq; // total frequency of all attractive arcs leaving a node
+	int unprocessed_count = Net->core_arcs.size(); // number of arcs not yet chosen in the main label setting loop
+	ArcQueue &arc_queue = work->arc_queue; // min-priority queue to quickly access the unprocessed arc with the minimum cost-plus-head-distance value
+	int sink = Net->stop_nodes[dest]->id; // node ID of the sink
+	for (int i = Net->in_start[sink]; i < Net->in_start[sink + 1]; i++)
 		// Set all non-infinite arc labels (which will include only the sink node's incoming arcs)
-		arc_queue.push(make_pair(arc_costs[Net->stop_nodes[dest]->core_in[i]->id], Net->stop_nodes[dest]->core_in[i]->id));
-	unordered_set<int> attractive_arcs; // set of attractive arcs
-	priority_queue<arc_cost_pair, vector<arc_cost_pair>, less<arc_cost_pair>> load_queue; // max-priority queue to process attractive arcs in reverse order
-	stack<arc_cost_pair> nonzero_flows; // stack of flow increase/arc ID pairs for quickly processing only the nonzero updates
+		arc_queue.push(arc_costs[Net->in_arcs[i]], Net->in_arcs[i]);
+	PROFILE_LOCAL_COUNT(profile, COUNT_HEAP_PUSHES, Net->in_start[sink + 1] - Net->in_start[sink]);
 
 	// Main label setting loop
 
-	while ((unprocessed_arcs.empty() == false) && (arc_queue.empty() == false))
+	while ((unprocessed_count > 0) && (arc_queue.empty() == false))
 	{
 		// Find the arc that minimizes the sum of its head's label and its own cost
-		chosen_label = arc_queue.top().first;
-		chosen_arc = arc_queue.top().second;
-		arc_queue.pop();
+		arc_cost_pair chosen = arc_queue.pop();
+		chosen_label = chosen.first;
+		chosen_arc = chosen.second;
+		PROFILE_LOCAL_COUNT(profile, COUNT_HEAP_POPS, 1);
 
 		// Only proceed for unprocessed arcs
-		if (unprocessed_arcs.count(chosen_arc) == 0)
+		if (work->processed[chosen_arc] == work->pass)
+		{
+			PROFILE_LOCAL_COUNT(profile, COUNT_STALE_POPS, 1);
 			continue;
+		}
 
 		// Mark arc as processed and get its tail
-		unprocessed_arcs.erase(chosen_arc);
-		chosen_tail = Net->core_arcs[chosen_arc]->tail->id;
+		work->processed[chosen_arc] = work->pass;
+		unprocessed_count--;
+		chosen_tail = Net->arc_tail[chosen_arc];
 
 		// Skip arcs with zero frequency (can occur for boarding arcs on lines with no vehicles)
 		if (freq[chosen_arc] == 0)
@@ -142,45 +379,72 @@ void ConstantAssignment::flows_to_destination(int dest, vector<double> &flows, d
 				node_freq[chosen_tail] = INFINITY;
 
 				// Remove all other attractive arcs leaving the tail
-				for (int i = 0; i < Net->core_nodes[chosen_tail]->core_out.size(); i++)
-					attractive_arcs.erase(Net->core_nodes[chosen_tail]->core_out[i]->id);
+				for (int i = Net->out_start[chosen_tail]; i < Net->out_start[chosen_tail + 1]; i++)
+					work->attractive[Net->out_arcs[i]] = 0;
 			}
 
-			// Add arc to attractive arc set
-			attractive_arcs.insert(chosen_arc);
+			// Add arc to attractive arc set and record its position in the processing order
+			work->attractive[chosen_arc] = work->pass;
+			work->order.push_back(chosen_arc);
 
 			// Update arc labels that are affected by the updated tail node
-			for (int i = 0; i < Net->core_nodes[chosen_tail]->core_in.size(); i++)
+			for (int i = Net->in_start[chosen_tail]; i < Net->in_start[chosen_tail + 1]; i++)
 			{
-				// Find arcs to update, recalculate labels, and push updates into priority queue
-				updated_arc = Net->core_nodes[chosen_tail]->core_in[i]->id;
-				updated_label = arc_costs[Net->core_arcs[updated_arc]->id] + node_label[chosen_tail];
-				arc_queue.push(make_pair(updated_label, updated_arc));
+				// Find unprocessed arcs to update, recalculate labels, and push updates into priority queue
+				updated_arc = Net->in_arcs[i];
+				if (work->processed[updated_arc] == work->pass)
+					continue;
+				updated_label = arc_costs[updated_arc] + node_label[chosen_tail];
+				arc_queue.push(updated_label, updated_arc);
+				PROFILE_LOCAL_COUNT(profile, COUNT_HEAP_PUSHES, 1);
 			}
 		}
 	}
 
-	// Build updated max-priority queue for attractive arc set
+	PROFILE_LOCAL_COUNT(profile, COUNT_ATTRACTIVE, work->order.size());
+	PROFILE_STOP(label_timer);
 
-	for (auto a = attractive_arcs.begin(); a != attractive_arcs.end(); a++)
-	{
-		// Recalculate the cost-plus-head label for each attractive arc and place in a max-priority queue
-		load_queue.push(make_pair(node_label[Net->core_arcs[*a]->head->id] + arc_costs[Net->core_arcs[*a]->id], *a));
-	}
+	// Distribute the destination's demand over the attractive arcs
+	load_flows(dest, flows, waiting, freq, work);
+}
+
+/**
+Loads the travel demand for a given sink onto its attractive arcs.
+
+Requires the sink index (as a position in the stop node list), flow vector, waiting time scalar, line frequency vector, and a pointer to the calling worker's workspace, respectively.
+
+The workspace must contain the attractive arc set of the sink's hyperpath, the order in which the attractive arcs were chosen, and the total attractive frequency of every node. The flow vector and waiting time are incremented in the same way as flows_to_destination().
+*/
+void ConstantAssignment::load_flows(int dest, vector<double> &flows, double &waiting, const vector<double> &freq, Workspace * work)
+{
+	PROFILE_SCOPE(load_timer, TIME_LOAD);
+
+	// Initialize variables
+	int chosen_arc; // arc ID chosen for current loop iteration
+	int chosen_tail; // tail node ID chosen for current loop iteration
+	int chosen_head; // head node ID chosen for current loop iteration
+	double added_flow; // chosen arc's added flow volume
 
-	vector<double>().swap(node_label); // clear node label vector, which is no longer needed
+	// Initialize containers from the workspace
+	vector<double> &node_freq = work->node_freq; // total frequency of all attractive arcs leaving a node
+	vector<double> &node_vol = work->node_vol; // total flow leaving a node
+	for (int k = Net->od_start[dest]; k < Net->od_start[dest + 1]; k++)
+		// Initialize travel volumes for the destination's nonzero origins
+		node_vol[Net->od_origin[k]] = Net->od_volume[k];
+	vector<double> &node_wait = work->node_wait; // expected waiting time at each node
 
 	// Main arc loading loop
 
-	while (load_queue.empty() == false)
+	for (int k = work->order.size() - 1; k >= 0; k--)
 	{
 		// Process attractive arcs in descending order of cost-plus-head-label value
 
-		// Get next arc's properties and remove from queue
-		chosen_arc = load_queue.top().second;
-		load_queue.pop();
-		chosen_tail = Net->core_arcs[chosen_arc]->tail->id;
-		chosen_head = Net->core_arcs[chosen_arc]->head->id;
+		// Get next arc's properties, skipping arcs which are no longer attractive
+		chosen_arc = work->order[k];
+		if (work->attractive[chosen_arc] != work->pass)
+			continue;
+		chosen_tail = Net->arc_tail[chosen_arc];
+		chosen_head = Net->arc_head[chosen_arc];
 
 		// Distribute volume from tail
 		if (freq[chosen_arc] < INFINITY)
@@ -193,11 +457,11 @@ void ConstantAssignment::flows_to_destination(int dest, vector<double> &flows, d
 			// Infinite-frequency arc
 			added_flow = node_vol[chosen_tail]; // all flow goes to single outgoing arc
 
-		// If this results in a nonzero flow increase, update the head and add the change to an update stack
+		// If this results in a nonzero flow increase, update the head and the arc flow
 		if (added_flow > 0)
 		{
 			node_vol[chosen_head] += added_flow;
-			nonzero_flows.push(make_pair(added_flow, chosen_arc));
+			flows[chosen_arc] += added_flow;
 		}
 	}
 
@@ -206,19 +470,51 @@ void ConstantAssignment::flows_to_destination(int dest, vector<double> &flows, d
 	for (int i = 0; i < node_wait.size(); i++)
 		total_wait += node_wait[i];
 
-	// Process nonzero flow queue while reader/writer lock is engaged
-	flow_lock->lock();
-	while (nonzero_flows.empty() == false)
+	waiting += total_wait;
+}
+
+/// Workspace constructor sizes the node and arc arrays for a given number of core nodes and core arcs.
+Workspace::Workspace(int node_count, int arc_count) : arc_queue(arc_count)
+{
+	node_label.resize(node_count, INFINITY);
+	node_freq.resize(node_count, 0.0);
+	node_vol.resize(node_count, 0.0);
+	node_wait.resize(node_count, 0.0);
+	processed.resize(arc_count, 0);
+	attractive.resize(arc_count, 0);
+	order.reserve(arc_count);
+}
+
+/**
+Begins a new label setting pass.
+
+Restores the node arrays to their initial values and empties the queue, neither of which releases any memory. Advancing the pass number marks every arc as unprocessed and unattractive without touching the arc arrays, which only need to be cleared when the pass number wraps around.
+*/
+void Workspace::reset()
+{
+	fill(node_label.begin(), node_label.end(), INFINITY);
+	fill(node_freq.begin(), node_freq.end(), 0.0);
+	fill(node_vol.begin(), node_vol.end(), 0.0);
+	fill(node_wait.begin(), node_wait.end(), 0.0);
+	arc_queue.reset();
+
+	pass++;
+	if (pass == 0)
 	{
-		chosen_arc = nonzero_flows.top().second;
-		added_flow = nonzero_flows.top().first;
-		flows[chosen_arc] += added_flow; // apply nonzero flow increase from stack
-		nonzero_flows.pop();
+		fill(processed.begin(), processed.end(), 0);
+		fill(attractive.begin(), attractive.end(), 0);
+		pass = 1;
 	}
-	flow_lock->unlock();
+	order.clear();
+}
 
-	// Increment total waiting time while reader/writer lock is engaged
-	wait_lock->lock();
-	waiting += total_wait;
-	wait_lock->unlock();
+/// Returns the number of bytes currently reserved by the workspace's containers.
+size_t Workspace::memory()
+{
+	size_t total = sizeof(Workspace);
+	total += (node_label.capacity() + node_freq.capacity() + node_vol.capacity() + node_wait.capacity()) * sizeof(double);
+	total += arc_queue.memory();
+	total += (processed.capacity() + attractive.capacity()) * sizeof(unsigned int);
+	total += order.capacity() * sizeof(int);
+	return total;
 }
@@ -2,7 +2,7 @@
 
 #include "assignment.hpp"
 
-/// Nonlinear assignment constructor reads in model data from file and sets network pointer.
+/// Nonlinear assignment constructor takes the model parameters from the network's input data and sets network pointer.
 NonlinearAssignment::NonlinearAssignment(Network * net_in)
 {
 	Net = net_in;
@@ -10,54 +10,76 @@ NonlinearAssignment::NonlinearAssignment(Network * net_in)
 	// Initialize submodel object
 	Submodel = new ConstantAssignment(net_in);
 
-	// Read assignment model data
-	ifstream a_file;
-	a_file.open(FILE_BASE + ASSIGNMENT_FILE);
-	if (a_file.is_open())
+	// Get model parameters from the rows of the assignment data (the integer parameters are only converted once they are known to be in range)
+	vector<double> &values = Net->Input->assignment_values;
+	if (parameters_valid(values) == false)
 	{
-		string line, piece; // whole line and line element being read
-		getline(a_file, line); // skip comment line
-		int count = 0;
+		cin.get();
+		exit(INCORRECT_FILE);
+	}
+	error_tol = values[0];
+	flow_tol = values[1];
+	waiting_tol = values[2];
+	max_iterations = values[3];
+	conical_alpha = values[5];
+	conical_beta = values[6];
+	if (values.size() > 7)
+		step_rule = values[7];
+	if (values.size() > 8)
+		direction_rule = values[8];
+}
+
+/**
+Checks the rows of the assignment data.
+
+Requires the vector of values from the assignment data file and the stream on which to describe any problems (the console by default).
 
-		while (a_file.eof() == false)
+Returns true if every required parameter is present, the iteration cutoff is a nonnegative value within the integer range, and the optional step size and search direction rules are recognized. The conjugate direction relies on the exact line search, so it is rejected together with the method of successive averages rather than being silently ignored. A message is written for each problem found.
+*/
+bool NonlinearAssignment::parameters_valid(const vector<double> &values, ostream &out)
+{
+	if (values.size() < ASSIGNMENT_ROWS)
+	{
+		out << "Assignment file is missing model parameters." << endl;
+		return false;
+	}
+
+	// Compare the values themselves before converting, since NaN or out of range values cannot be converted to integers
+	int step = STEP_MSA;
+	int direction = DIRECTION_FW;
+	bool valid = true;
+	if (((values[3] >= 0) == false) || ((values[3] <= numeric_limits<int>::max()) == false))
+	{
+		out << "Assignment file has an invalid iteration cutoff " << values[3] << "." << endl;
+		valid = false;
+	}
+	if (values.size() > 7)
+	{
+		if ((values[7] == STEP_MSA) || (values[7] == STEP_LINE_SEARCH))
+			step = values[7];
+		else
 		{
-			count++;
-
-			// Get whole line as a string stream
-			getline(a_file, line);
-			if (line.size() == 0)
-				// Break for blank line at file end
-				break;
-			stringstream stream(line);
-
-			// Go through each piece of the line
-			getline(stream, piece, '\t'); // Label
-			getline(stream, piece, '\t'); // Value
-			string value = piece;
-
-			// Expected data
-			if (count == 1)
-				error_tol = stod(value);
-			if (count == 2)
-				flow_tol = stod(value);
-			if (count == 3)
-				waiting_tol = stod(value);
-			if (count == 4)
-				max_iterations = stoi(value);
-			if (count == 6)
-				conical_alpha = stod(value);
-			if (count == 7)
-				conical_beta = stod(value);
+			out << "Assignment file has an unrecognized step size rule " << values[7] << "." << endl;
+			valid = false;
 		}
-
-		a_file.close();
 	}
-	else
+	if (values.size() > 8)
 	{
-		cout << "Assignment file failed to open." << endl;
-		cin.get();
-		exit(FILE_NOT_FOUND);
+		if ((values[8] == DIRECTION_FW) || (values[8] == DIRECTION_CONJUGATE))
+			direction = values[8];
+		else
+		{
+			out << "Assignment file has an unrecognized search direction rule " << values[8] << "." << endl;
+			valid = false;
+		}
 	}
+	if ((valid == true) && (direction == DIRECTION_CONJUGATE) && (step != STEP_LINE_SEARCH))
+	{
+		out << "Assignment file requests the conjugate direction, which requires the exact line search step size rule." << endl;
+		valid = false;
+	}
+
+	return valid;
 }
 
 /// Nonlinear assignment destructor deletes the submodel created by the constructor.
@@ -69,67 +91,82 @@ NonlinearAssignment::~NonlinearAssignment()
 /**
 Nonlinear cost assignment model evaluation for a given solution.
 
-Requires a fleet size vector and an initial solution, which takes the form of a pair made up of a flow vector and a waiting time scalar.
+Requires a fleet size vector, an initial solution, which takes the form of a pair made up of a flow vector and a waiting time scalar, and a reference to an integer to hold the number of Frank-Wolfe iterations performed.
 
 Returns a pair containing a vector of flow values and a waiting time scalar.
 
 The solution vector is used to determine the frequency and capacity of each line. Frequencies contribute to boarding arc costs for the common lines problem, while capacities contribute to an overcrowding penalty to model congestion.
 
 The overall process being used here is the Frank-Wolfe algorithm, which iteratively solves the linear approximation of the nonlinear cost quadratic program. That linear approximation happens to be an instance of the constant-cost LP whose costs are based on the current solution.
+
+Each iteration moves the current solution toward the constant-cost solution (or, for the conjugate direction, toward a combination of it and the previous iteration's target). The step size is either the method of successive averages step or the exact minimizer of the objective along the search direction.
 */
-pair<vector<double>, double> NonlinearAssignment::calculate(const vector<int> &fleet, const pair<vector<double>, double> &initial_sol)
+pair<vector<double>, double> NonlinearAssignment::calculate(const vector<int> &fleet, const pair<vector<double>, double> &initial_sol, int &iterations)
 {
-	cout << '*';
+	PROFILE_COUNT(COUNT_EVALUATIONS, 1);
 
 	// Initialize variables
 	pair<vector<double>, double> sol_next; // flow/waiting pair calculated as the linearized submodel solution
 	pair<vector<double>, double> sol_previous; // flow/waiting pair for the previous solution
+	pair<vector<double>, double> sol_conjugate; // flow/waiting pair for the previous conjugate direction's target (empty until the first one is found)
 	int iteration = 0; // current iteration number
 	double error = INFINITY; // current solution error bound
 	pair<double, double> change = make_pair(INFINITY, INFINITY); // flow/waiting time differences between consecutive solutions
 
 	// Calculate line arc capacities
 	vector<double> capacities(Net->core_arcs.size(), INFINITY);
-	for_each(Net->line_arcs.begin(), Net->line_arcs.end(), [&](Arc * a)
-	{
-		capacities[a->id] = Net->lines[a->line]->capacity(fleet[a->line]);
-	});
+	for (int i = 0; i < Net->core_arcs.size(); i++)
+		if (Net->arc_type[i] == LINE_ARC)
+			capacities[i] = Net->lines[Net->arc_line[i]]->capacity(fleet[Net->arc_line[i]]);
 
 	// Calculate arc costs based on initial flow
-	cout << '.';
 	vector<double> arc_costs(Net->core_arcs.size());
-	for_each(Net->core_arcs.begin(), Net->core_arcs.end(), [&](Arc * a)
-	{
-		arc_costs[a->id] = arc_cost(a->id, initial_sol.first[a->id], capacities[a->id]);
-	});
+	update_costs(initial_sol.first, capacities, arc_costs);
 
 	// Solve constant-cost model once to obtain an initial solution
 	sol_previous = Submodel->calculate(fleet, arc_costs);
 
+	// Update all arc costs based on the initial solution (later updates are combined with the solution update)
+	update_costs(sol_previous.first, capacities, arc_costs);
+
 	// Main Frank-Wolfe loop
 
 	while ((iteration < max_iterations) && (error > error_tol) && ((change.first > flow_tol) || (change.second > waiting_tol)))
 	{
 		// Loop continues until achieving sufficiently low error or reaching an iteration cutoff
 		iteration++;
-		cout << '.';
-
-		// Update all arc costs based on the current flow
-		for_each(Net->core_arcs.begin(), Net->core_arcs.end(), [&](Arc * a)
-		{
-			arc_costs[a->id] = arc_cost(a->id, sol_previous.first[a->id], capacities[a->id]);
-		});
+		PROFILE_COUNT(COUNT_FW_ITERATIONS, 1);
+		TRACE_SCOPE(iteration_span, "fw_iteration", iteration);
 
-		// Solve constant-cost model for given cost vector
+		// Solve constant-cost model for the cost vector of the current flow
 		sol_next = Submodel->calculate(fleet, arc_costs);
 
-		// Calculate new error bound
-		error = obj_error(capacities, sol_previous.first, sol_previous.second, sol_next.first, sol_next.second);
-
-		// Update solution as successive average of consecutive solutions and get maximum elementwise difference
-		change = solution_update(1 - (1.0 / iteration), sol_previous.first, sol_previous.second, sol_next.first, sol_next.second);
+		// Choose step size, and if requested replace the constant-cost solution with a conjugate direction target
+		double step; // fraction of the distance to move toward the target solution
+		if (step_rule == STEP_LINE_SEARCH)
+		{
+			PROFILE_SCOPE(line_search_timer, TIME_LINE_SEARCH);
+			// The error bound is based on the constant-cost solution, so it must be found before any conjugate target replaces it
+			error = obj_error(arc_costs, sol_previous.first, sol_previous.second, sol_next.first, sol_next.second);
+			if (direction_rule == DIRECTION_CONJUGATE)
+				conjugate_direction(capacities, sol_previous, sol_next, sol_conjugate);
+			step = line_search(capacities, sol_previous.first, sol_previous.second, sol_next.first, sol_next.second);
+		}
+		else
+			step = 1.0 / iteration;
+
+		// Update solution as a convex combination of consecutive solutions, along with the arc costs, and get the error bound and maximum elementwise difference
+		double update_error; // error bound found during the update, which is relative to the target solution
+		PROFILE_SCOPE(update_timer, TIME_UPDATE);
+		change = solution_update(1 - step, capacities, sol_previous.first, sol_previous.second, sol_next.first, sol_next.second, arc_costs, update_error);
+		if (step_rule == STEP_MSA)
+			error = update_error;
 	}
 
+	// Record which stopping condition ended the loop
+	PROFILE_COUNT((error <= error_tol) ? COUNT_FW_ERROR : (((change.first <= flow_tol) && (change.second <= waiting_tol)) ? COUNT_FW_CHANGE : COUNT_FW_CUTOFF), 1);
+
+	iterations = iteration;
 	return sol_previous;
 }
 
@@ -142,69 +179,209 @@ Returns the arc's cost according to the conical congestion function.
 */
 double NonlinearAssignment::arc_cost(int id, double flow, double capacity)
 {
-	// Return infinite cost for zero-capacity arcs
-	if (capacity == 0)
-		return LARGE;
+	return conical_cost(flow, capacity, Net->arc_cost[id], conical_alpha, conical_beta, conical_beta*conical_beta);
+}
 
-	// Return only the arc's base cost for infinite-capacity or zero-flow arcs
-	if ((capacity >= INFINITY) || (flow == 0))
-		return Net->core_arcs[id]->cost;
+/**
+Calculates the nonlinear cost function for all arcs.
+
+Requires references to the flow vector, the capacity vector, and the vector to hold the arc costs, respectively.
+
+Overwrites the cost vector with the cost of each arc according to the conical congestion function, using the batch kernel.
+*/
+void NonlinearAssignment::update_costs(const vector<double> &flows, const vector<double> &capacities, vector<double> &costs)
+{
+	conical_costs(Net->core_arcs.size(), flows.data(), capacities.data(), Net->arc_cost.data(), conical_alpha, conical_beta, costs.data());
+}
+
+/**
+Calculates the derivative of the nonlinear cost function for a given arc.
+
+Requires the arc ID, arc flow, and arc capacity.
+
+Returns the derivative of the arc's cost with respect to its flow, which is zero for arcs whose cost does not depend on flow.
+*/
+double NonlinearAssignment::arc_cost_derivative(int id, double flow, double capacity)
+{
+	// Zero-capacity and infinite-capacity arcs have constant costs
+	if ((capacity == 0) || (capacity >= INFINITY))
+		return 0.0;
 
 	/*
-	Otherwise, evaluate the conical congestion function, which is defined as:
-		c(x) = c * (2 + sqrt((alpha * (1 - x/u))^2 + beta^2) - alpha * (1 - x/u) - beta)
-	where c(x) is the nonlinear cost, x is the arc's flow, c is the arc's base cost, u is the arc's capacity, and alpha and beta are parameters.
+	Differentiating the conical congestion function gives:
+		c'(x) = (c * alpha / u) * (1 - alpha * (1 - x/u) / sqrt((alpha * (1 - x/u))^2 + beta^2))
 	*/
 	double ratio = 1 - (flow / capacity);
-	return Net->core_arcs[id]->cost * (2 + sqrt(pow(conical_alpha*ratio, 2) + pow(conical_beta, 2)) - (conical_alpha * ratio) - conical_beta);
+	return (Net->arc_cost[id] * conical_alpha / capacity) * (1 - conical_alpha*ratio / sqrt(pow(conical_alpha*ratio, 2) + pow(conical_beta, 2)));
 }
 
 /**
 Calculates an error bound for the current objective value based on the difference between consecutive solutions.
 
-Requires references to the capacity vector, the current flow vector, the current waiting time, the next flow vector, and the next waiting time, respectively.
+Requires references to the cost vector for the current flow, the current flow vector, the current waiting time, the next flow vector, and the next waiting time, respectively.
 
 Returns an upper bound for the absolute error in the current solution.
 
 The Frank-Wolfe algorithm includes a means for bounding the absolute error of the current solution based on the objective values of the previous solutions. Since our algorithm never explicitly evaluates the objective value (only values of the linearized objective), we instead use a looser but more easily calculated bound that involves the difference between consecutive linearized objective values.
 */
-double NonlinearAssignment::obj_error(const vector<double> &capacities, const vector<double> &flows_old, double waiting_old, const vector<double> &flows_new, double waiting_new)
+double NonlinearAssignment::obj_error(const vector<double> &costs, const vector<double> &flows_old, double waiting_old, const vector<double> &flows_new, double waiting_new)
 {
 	// Calculate error term-by-term
 	double total = waiting_old - waiting_new;
 	for (int i = 0; i < Net->core_arcs.size(); i++)
-		total += arc_cost(Net->core_arcs[i]->id, flows_old[i], capacities[i]) * (flows_old[i] - flows_new[i]);
+		total += costs[i] * (flows_old[i] - flows_new[i]);
 
 	return abs(total);
 }
 
 /**
-Updates the solution according to the convex combination found from the line search.
+Updates the solution according to the convex combination found from the line search, and updates the arc costs to match.
 
-Requires a value for the convex parameter, followed by references to the current flow vector, the current waiting time, the next flow vector, and the next waiting time, respectively.
+Requires a value for the convex parameter, followed by references to the capacity vector, the current flow vector, the current waiting time, the next flow vector, the next waiting time, the cost vector for the current flow, and a variable to hold the error bound, respectively.
 
-Updates the current solution in place as a convex combination of the two vectors.
+Updates the current solution in place as a convex combination of the two vectors, and overwrites the cost vector with the costs for the updated flow. The error bound for the current solution (as calculated by obj_error() before the update) is written to the error bound variable.
 
 Also returns a pair containing the maximum elementwise flow vector change and the waiting time change, respectively.
+
+Every step which reads or writes full-length vectors is combined into a single pass over the arcs, which handles a block of arcs at a time so that the block's updated flows are still in cache when its new costs are calculated.
 */
-pair<double, double> NonlinearAssignment::solution_update(double lambda, vector<double> &flows_current, double &waiting_current, const vector<double> &flows_next, double waiting_next)
+pair<double, double> NonlinearAssignment::solution_update(double lambda, const vector<double> &capacities, vector<double> &flows_current, double &waiting_current, const vector<double> &flows_next, double waiting_next, vector<double> &costs, double &error)
 {
 	double max_flow_diff = 0.0; // maximum elementwise flow difference
 	double waiting_diff; // waiting time difference
 	double element; // temporary variable for the updated element
+	double total = waiting_current - waiting_next; // error bound before taking its absolute value
 
 	// Update waiting time
 	element = lambda*waiting_current + (1 - lambda)*waiting_next;
 	waiting_diff = abs(waiting_current - element);
 	waiting_current = element;
 
-	// Update each flow variable
-	for (int i = 0; i < flows_current.size(); i++)
+	// Update each block of flow variables and costs
+	int arc_count = flows_current.size();
+	for (int start = 0; start < arc_count; start += UPDATE_BLOCK)
 	{
-		element = lambda*flows_current[i] + (1 - lambda)*flows_next[i];
-		max_flow_diff = max(abs(flows_current[i] - element), max_flow_diff);
-		flows_current[i] = element;
+		int end = min(start + UPDATE_BLOCK, arc_count);
+
+		for (int i = start; i < end; i++)
+		{
+			total += costs[i] * (flows_current[i] - flows_next[i]);
+			element = lambda*flows_current[i] + (1 - lambda)*flows_next[i];
+			max_flow_diff = max(abs(flows_current[i] - element), max_flow_diff);
+			flows_current[i] = element;
+		}
+
+		conical_costs(end - start, &flows_current[start], &capacities[start], &Net->arc_cost[start], conical_alpha, conical_beta, &costs[start]);
 	}
 
+	error = abs(total);
 	return make_pair(max_flow_diff, waiting_diff);
 }
+
+/**
+Finds the step size which minimizes the objective along the line between the current and next solutions.
+
+Requires references to the capacity vector, the current flow vector, the current waiting time, the next flow vector, and the next waiting time, respectively.
+
+Returns the step size in [0,1], where 0 corresponds to the current solution and 1 to the next solution.
+
+Every arc cost is nondecreasing in its flow, so the objective is convex along the line and its directional derivative is nondecreasing in the step size. The minimizer is therefore found by bisection on the sign of the directional derivative, unless the derivative is nonpositive over the whole line (in which case the full step is taken).
+*/
+double NonlinearAssignment::line_search(const vector<double> &capacities, const vector<double> &flows_current, double waiting_current, const vector<double> &flows_next, double waiting_next)
+{
+	// Check endpoints
+	if (directional_derivative(1.0, capacities, flows_current, waiting_current, flows_next, waiting_next) <= 0)
+		return 1.0;
+	if (directional_derivative(0.0, capacities, flows_current, waiting_current, flows_next, waiting_next) >= 0)
+		return 0.0;
+
+	// Bisect until the interval containing the minimizer is sufficiently small
+	double low = 0.0;
+	double high = 1.0;
+	while (high - low > LINE_SEARCH_TOL)
+	{
+		double middle = 0.5*(low + high);
+		if (directional_derivative(middle, capacities, flows_current, waiting_current, flows_next, waiting_next) > 0)
+			high = middle;
+		else
+			low = middle;
+	}
+
+	return 0.5*(low + high);
+}
+
+/**
+Calculates the derivative of the objective along the search direction.
+
+Requires a step size, followed by references to the capacity vector, the current flow vector, the current waiting time, the next flow vector, and the next waiting time, respectively.
+
+Returns the derivative of the objective at the given fraction of the distance from the current solution to the next solution, with respect to that fraction.
+
+The objective is the sum of the integrals of all arc costs plus the total waiting time, so its derivative is the sum of each arc's cost at the intermediate flow times the arc's change in flow, plus the change in waiting time.
+*/
+double NonlinearAssignment::directional_derivative(double step, const vector<double> &capacities, const vector<double> &flows_current, double waiting_current, const vector<double> &flows_next, double waiting_next)
+{
+	double total = waiting_next - waiting_current;
+	for (int i = 0; i < Net->core_arcs.size(); i++)
+	{
+		double difference = flows_next[i] - flows_current[i];
+		if (difference != 0)
+			total += arc_cost(i, flows_current[i] + step*difference, capacities[i]) * difference;
+	}
+
+	return total;
+}
+
+/**
+Replaces the next solution with the target of a conjugate Frank-Wolfe direction.
+
+Requires references to the capacity vector, the current solution, the next solution (the solution of the latest constant-cost model), and the previous conjugate direction's target.
+
+Updates the next solution in place, and stores a copy of it as the new conjugate direction target.
+
+The conjugate Frank-Wolfe method of Mitradjieva and Lindberg chooses the new target as a convex combination of the previous target and the constant-cost solution, weighted so that the new search direction is conjugate to the previous one with respect to the objective's Hessian. The Hessian is diagonal, with each arc's entry being the derivative of its cost, and the waiting time does not contribute since it enters the objective linearly. Consecutive directions which are conjugate avoid the zigzagging that slows down the standard method near the optimum.
+
+The standard direction is used instead on the first iteration, whenever the weights cannot be found, and whenever the combination fails to give a descent direction.
+*/
+void NonlinearAssignment::conjugate_direction(const vector<double> &capacities, const pair<vector<double>, double> &sol_current, pair<vector<double>, double> &sol_next, pair<vector<double>, double> &sol_conjugate)
+{
+	double weight = 0.0; // weight of the previous target in the new target
+
+	if (sol_conjugate.first.empty() == false)
+	{
+		/*
+		With H the Hessian, x the current solution, y the constant-cost solution, and s the previous target, the new direction is conjugate to the previous one (s - x) for the weight:
+			(s - x)'H(y - x) / (s - x)'H(y - s)
+		which is then restricted to [0, 1 - delta].
+		*/
+		double numerator = 0.0;
+		double denominator = 0.0;
+		for (int i = 0; i < Net->core_arcs.size(); i++)
+		{
+			double hessian = arc_cost_derivative(i, sol_current.first[i], capacities[i]);
+			if (hessian == 0)
+				continue;
+			double previous = sol_conjugate.first[i] - sol_current.first[i];
+			numerator += hessian * previous * (sol_next.first[i] - sol_current.first[i]);
+			denominator += hessian * previous * (sol_next.first[i] - sol_conjugate.first[i]);
+		}
+		if (denominator != 0)
+			weight = numerator / denominator;
+		if (weight > 1 - CONJUGATE_DELTA)
+			weight = 1 - CONJUGATE_DELTA;
+		if ((weight < 0) || (denominator == 0))
+			weight = 0.0;
+	}
+
+	if (weight > 0)
+	{
+		// Form the new target, and keep it only if it gives a descent direction
+		pair<vector<double>, double> target(vector<double>(sol_next.first.size()), weight*sol_conjugate.second + (1 - weight)*sol_next.second);
+		for (int i = 0; i < target.first.size(); i++)
+			target.first[i] = weight*sol_conjugate.first[i] + (1 - weight)*sol_next.first[i];
+		if (directional_derivative(0.0, capacities, sol_current.first, sol_current.second, target.first, target.second) < 0)
+			sol_next.swap(target);
+	}
+
+	sol_conjugate = sol_next;
+}
@@ -0,0 +1,255 @@
+/**
+The main function for the batch runner, which runs the user cost search on a list of instances within a single process.
+
+Every instance directory must contain the data/ and log/ folders expected by the user cost search, and each instance's results are written to its own log/ folder exactly as for a single run. All instances share one thread pool. A given number of instance slots run at once, and each slot loads, solves, and frees one instance at a time before moving on to the next unstarted instance, so that no more instances than slots are ever held in memory. Each slot runs on its own thread, which takes one of the pool's reserved worker IDs and calls into the pool like any other outside thread. The slots are therefore never pool tasks themselves, so a worker waiting on one instance's tasks can never find itself running another whole instance. Every slot occupies a worker, so there is at most one slot per worker.
+
+The batch runs without any interaction. The console output of the individual searches is suppressed, and a single line is printed (to the standard log stream) whenever an instance finishes, giving the reason for any failure. A row of results for each instance is appended to the summary file as soon as the instance finishes, and the instances that were never started are listed at the end.
+
+As for a single run, SIGINT and SIGTERM stop every running search at a checkpoint, after which no more instances are started. Running the same batch again resumes the interrupted instances from their checkpoints, while finished instances are quickly solved again from their solution logs.
+
+Command line options:
+	-f <file>: file listing instance directories, one per line, with blank lines and lines beginning with '#' ignored (may be combined with directories given directly)
+	-j <instances>: number of instances to solve at once (default 1, at most one per worker thread)
+	-o <file>: summary file (default batch_summary.txt)
+	-t <threads>: number of worker threads to use (default 0, meaning one per hardware thread)
+	any other argument: an instance directory
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "input_data.hpp"
+#include "network.hpp"
+#include "search.hpp"
+#include "thread_pool.hpp"
+
+#define BATCH_SUMMARY_FILE "batch_summary.txt" // default summary file
+
+using namespace std;
+
+// Global thread pool pointer
+ThreadPool * Pool;
+
+// Global file base name (set by each slot to its current instance's directory)
+thread_local string FILE_BASE = "";
+
+/**
+Loads, solves, and frees a single instance.
+
+Requires the instance directory (ending in a slash), which must already be the calling thread's file base, and references to strings to hold the instance's status and the reason for a failure.
+
+Returns the instance's row of the summary file.
+
+The status is "solved" for a finished search, "interrupted" for a search stopped by a signal, or "failed" if the input data could not be loaded. Data which would end the whole process when the search objects are created (such as missing model parameters) are checked beforehand, so that a single bad instance only fails itself. Since console output is suppressed, the description of the problem is returned as the reason instead, and is also written to the summary row.
+*/
+string run_instance(const string &directory, string &status, string &reason)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	ostringstream row;
+	row << fixed << setprecision(15) << directory << '\t';
+
+	// Load input data, and describe the first problem that would stop the search
+	InputData * data = new InputData();
+	ostringstream problems;
+	if (data->load() == false)
+		reason = data->error.empty() ? "Failed to load input data." : data->error;
+	else if (data->user_cost_values.size() < USER_COST_ROWS)
+		reason = "Constraint file is missing user cost weights.";
+	else if (NonlinearAssignment::parameters_valid(data->assignment_values, problems) == false)
+	{
+		reason = problems.str();
+		reason.erase(reason.find_last_not_of('\n') + 1);
+		replace(reason.begin(), reason.end(), '\n', ' ');
+	}
+	if (reason.empty() == false)
+	{
+		delete data;
+		status = "failed";
+		row << status << "\t\t\t" << setprecision(3) << chrono::duration<double>(chrono::steady_clock::now() - start).count() << "\t\t" << reason;
+		return row.str();
+	}
+
+	// Solve instance without console output
+	Search * Solver = new Search(new Network(data));
+	Solver->Con->Events->console = false;
+	Solver->solve();
+
+	// The best solution is only updated by a finished search
+	status = "solved";
+	vector<int> sol = Solver->sol_best;
+	double obj = Solver->obj_best;
+	if (Interrupted == true)
+	{
+		status = "interrupted";
+		sol = Solver->sol_current;
+		obj = Solver->obj_current;
+	}
+	row << status << '\t' << obj << '\t' << Solver->exhaustive_iteration << '\t' << setprecision(3) << chrono::duration<double>(chrono::steady_clock::now() - start).count() << '\t' << vec2str(sol) << '\t';
+
+	delete Solver;
+	return row.str();
+}
+
+/**
+Reads a list of instance directories from a file.
+
+Requires the file name and a reference to the vector of directories, to which the file's directories are appended.
+
+Returns true if the file was read, and false if it could not be opened.
+*/
+bool read_list(const string &file_name, vector<string> &directories)
+{
+	ifstream list_file(file_name);
+	if (list_file.is_open() == false)
+		return false;
+
+	string line;
+	while (getline(list_file, line))
+	{
+		// Trim whitespace and skip blank and comment lines
+		line.erase(line.find_last_not_of(" \t\r") + 1);
+		line.erase(0, line.find_first_not_of(" \t"));
+		if ((line.empty() == true) || (line[0] == '#'))
+			continue;
+		directories.push_back(line);
+	}
+
+	return true;
+}
+
+/// Batch driver
+int main(int argc, char *argv[])
+{
+	// Read command line options
+	vector<string> directories;
+	int slots = 1;
+	string summary_name = BATCH_SUMMARY_FILE;
+	int threads = DEFAULT_THREADS;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc))
+		{
+			if (read_list(argv[++i], directories) == false)
+			{
+				cout << "Failed to read instance list " << argv[i] << "." << endl;
+				return FILE_NOT_FOUND;
+			}
+		}
+		else if ((strcmp(argv[i], "-j") == 0) && (i + 1 < argc))
+			slots = max(1, atoi(argv[++i]));
+		else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+			summary_name = argv[++i];
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+			threads = atoi(argv[++i]);
+		else if (argv[i][0] == '-')
+		{
+			cout << "Unrecognized option " << argv[i] << "." << endl;
+			return INCORRECT_OPTION;
+		}
+		else
+			directories.push_back(argv[i]);
+	}
+	if (directories.empty() == true)
+	{
+		cout << "No instance directories given." << endl;
+		return INCORRECT_OPTION;
+	}
+	for (int i = 0; i < directories.size(); i++)
+		if (directories[i].back() != '/')
+			directories[i] += '/';
+
+	// Decide how many instances to solve at once, and initialize worker threads with one reserved worker for each slot
+	slots = min(slots, (int) directories.size());
+	if ((slots > 1) && ((INSTRUMENT != INSTRUMENT_OFF) || (TRACE == 1)))
+	{
+		// The profiler and trace recorder are shared by the whole process, so they can only follow one instance at a time
+		cout << "Instrumentation and tracing require solving one instance at a time." << endl;
+		slots = 1;
+	}
+	Pool = new ThreadPool(threads, slots);
+	slots = Pool->caller_count;
+
+	// Open summary file
+	ofstream summary_file(summary_name);
+	if (summary_file.is_open() == false)
+	{
+		cout << "Failed to write batch summary." << endl;
+		delete Pool;
+		return WRITE_FAILED;
+	}
+	summary_file << "Instance\tStatus\tObjective\tIterations\tSeconds\tSolution\tReason" << endl;
+
+	// Suppress the searches' console output, and stop at checkpoints if interrupted
+	cout.setstate(ios_base::failbit);
+	signal(SIGINT, interrupt_search);
+	signal(SIGTERM, interrupt_search);
+
+	// Each slot solves unstarted instances one at a time on its own thread until none remain
+	atomic<int> next_instance(0); // index of the next instance to start
+	vector<char> started(directories.size(), false); // whether each instance has been started
+	int finished = 0; // number of finished instances
+	int failures = 0; // number of instances whose data could not be loaded
+	mutex summary_lock; // lock for the summary file, the standard log stream, and the finished instance counters
+	vector<thread> slot_threads;
+	for (int s = 0; s < slots; s++)
+	{
+		slot_threads.push_back(thread([&, s]()
+		{
+			// This thread only waits for the slots, so the first slot may take its worker ID
+			ThreadPool::attach(s);
+			while (Interrupted == false)
+			{
+				int i = next_instance++;
+				if (i >= directories.size())
+					break;
+				started[i] = true;
+				FILE_BASE = directories[i];
+				string status;
+				string reason;
+				string row = run_instance(directories[i], status, reason);
+
+				lock_guard<mutex> guard(summary_lock);
+				summary_file << row << endl;
+				finished++;
+				if (status == "failed")
+					failures++;
+				clog << '[' << finished << '/' << directories.size() << "] " << directories[i] << ' ' << status;
+				if (reason.empty() == false)
+					clog << ": " << reason;
+				clog << endl;
+			}
+		}));
+	}
+	for (int s = 0; s < slot_threads.size(); s++)
+		slot_threads[s].join();
+
+	// List instances which were never started
+	for (int i = 0; i < directories.size(); i++)
+		if (started[i] == false)
+			summary_file << directories[i] << "\tskipped\t\t\t\t\t" << endl;
+	summary_file.close();
+
+	delete Pool;
+	cout.clear();
+	if (summary_file.fail() == true)
+	{
+		cout << "Failed to write batch summary." << endl;
+		return WRITE_FAILED;
+	}
+	if (Interrupted == true)
+		return SEARCH_INTERRUPTED;
+	if (failures > 0)
+		return INCORRECT_FILE;
+	return SUCCESSFUL_EXIT;
+}
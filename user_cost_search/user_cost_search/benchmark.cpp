@@ -0,0 +1,309 @@
+/**
+The main function for the benchmark suite, which times the hot paths of the assignment model and the search on synthetic grid instances.
+
+Each grid instance is a square grid of stops with one line along every row and every column, stopping at every stop along the way, along with walking arcs between neighboring stops and random travel demands between a fraction of all stop pairs. The instances are generated in memory and are deterministic for a given seed, so results are comparable between builds and between machines.
+
+For every grid size and thread count the following are timed:
+	destination: ConstantAssignment::flows_to_destination() for the single heaviest destination
+	constant: ConstantAssignment::calculate() for all destinations
+	nonlinear: NonlinearAssignment::calculate() from a zero initial solution
+	neighbor: one full Search::best_neighbor() sweep from the initial solution, with the solution log emptied before each sweep
+
+Every benchmark is run once untimed to warm up, and then timed for the requested number of repetitions. Results are written to standard output as CSV, with one row per benchmark, grid size, and thread count. All other console output is suppressed.
+
+Command line options:
+	-g <sizes>: comma-separated list of grid sizes, each the number of stops along one side of the grid (default 4,6,8)
+	-t <threads>: comma-separated list of thread counts, with 0 meaning one per hardware thread (default 1,2,4)
+	-r <repetitions>: number of timed repetitions of each benchmark (default 5)
+	-s <seed>: seed for the random travel demands and initial fleet sizes (default 1)
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "input_data.hpp"
+#include "search.hpp"
+#include "thread_pool.hpp"
+
+#define BENCHMARK_DEMAND_DENSITY 0.3 // fraction of stop pairs with nonzero travel demand
+#define BENCHMARK_LINE_TIME 3.0 // in-vehicle travel time between neighboring stops
+#define BENCHMARK_WALK_TIME 12.0 // walking time between neighboring stops
+
+using namespace std;
+
+// Global thread pool pointer
+ThreadPool * Pool;
+
+// Global file base name
+thread_local string FILE_BASE = "";
+
+/// Converts a comma-separated list of integers into a vector.
+vector<int> parse_list(const string &list)
+{
+	vector<int> out;
+	stringstream list_stream(list);
+	string element;
+
+	while (getline(list_stream, element, ','))
+		out.push_back(stoi(element));
+
+	return out;
+}
+
+/**
+Generates a synthetic grid instance.
+
+Requires the number of stops along one side of the grid (at least 2) and a random seed.
+
+Returns a pointer to a new input data object describing the instance, with the same parameter values used for the test instances.
+*/
+InputData * grid_instance(int size, unsigned int seed)
+{
+	InputData * grid = new InputData();
+	mt19937 generator(seed);
+	int stop_count = size * size;
+	int line_count = 2 * size;
+
+	// Add a stop node at each grid point
+	for (int i = 0; i < stop_count; i++)
+	{
+		grid->node_id.push_back(i);
+		grid->node_type.push_back(STOP_NODE);
+		grid->node_value.push_back(-1);
+	}
+
+	// Add a line along each row and each column, with a boarding node at every stop
+	uniform_int_distribution<int> fleet_distribution(2, 6);
+	for (int line = 0; line < line_count; line++)
+	{
+		grid->line_type.push_back(0);
+		grid->line_fleet.push_back(fleet_distribution(generator));
+		grid->line_circuit.push_back(2 * BENCHMARK_LINE_TIME * (size - 1));
+		grid->line_scaling.push_back(1.0);
+		grid->line_lb.push_back(1);
+		grid->line_ub.push_back(12);
+
+		int first_boarding = grid->node_id.size(); // node ID of the line's first boarding node
+		for (int k = 0; k < size; k++)
+		{
+			int stop = (line < size) ? line * size + k : k * size + (line - size);
+			int boarding = first_boarding + k;
+			grid->node_id.push_back(boarding);
+			grid->node_type.push_back(BOARDING_NODE);
+			grid->node_value.push_back(-1);
+
+			// Boarding and alighting arcs
+			grid->arc_type.push_back(BOARDING_ARC);
+			grid->arc_line.push_back(line);
+			grid->arc_tail.push_back(stop);
+			grid->arc_head.push_back(boarding);
+			grid->arc_time.push_back(0.0);
+			grid->arc_type.push_back(ALIGHTING_ARC);
+			grid->arc_line.push_back(NO_ID);
+			grid->arc_tail.push_back(boarding);
+			grid->arc_head.push_back(stop);
+			grid->arc_time.push_back(0.0);
+		}
+
+		// Line arcs in both directions between consecutive boarding nodes
+		for (int k = 0; k + 1 < size; k++)
+		{
+			for (int direction = 0; direction < 2; direction++)
+			{
+				grid->arc_type.push_back(LINE_ARC);
+				grid->arc_line.push_back(line);
+				grid->arc_tail.push_back(first_boarding + k + direction);
+				grid->arc_head.push_back(first_boarding + k + 1 - direction);
+				grid->arc_time.push_back(BENCHMARK_LINE_TIME);
+			}
+		}
+	}
+
+	// Walking arcs in both directions between neighboring stops
+	for (int i = 0; i < stop_count; i++)
+	{
+		int neighbors[2] = { (i / size + 1 < size) ? i + size : NO_ID, (i % size + 1 < size) ? i + 1 : NO_ID }; // stops below and to the right
+		for (int j = 0; j < 2; j++)
+		{
+			if (neighbors[j] == NO_ID)
+				continue;
+			for (int direction = 0; direction < 2; direction++)
+			{
+				grid->arc_type.push_back(WALKING_ARC);
+				grid->arc_line.push_back(NO_ID);
+				grid->arc_tail.push_back((direction == 0) ? i : neighbors[j]);
+				grid->arc_head.push_back((direction == 0) ? neighbors[j] : i);
+				grid->arc_time.push_back(BENCHMARK_WALK_TIME);
+			}
+		}
+	}
+	for (int i = 0; i < grid->arc_type.size(); i++)
+		grid->arc_id.push_back(i);
+
+	// A single vehicle type shared by all lines
+	grid->vehicle_bound.push_back(8 * line_count);
+	grid->vehicle_capacity.push_back(3.0);
+
+	// Random travel demands
+	uniform_real_distribution<double> chance_distribution(0.0, 1.0);
+	uniform_real_distribution<double> volume_distribution(10.0, 400.0);
+	for (int i = 0; i < stop_count; i++)
+	{
+		for (int j = 0; j < stop_count; j++)
+		{
+			if ((i == j) || (chance_distribution(generator) >= BENCHMARK_DEMAND_DENSITY))
+				continue;
+			grid->od_origin.push_back(i);
+			grid->od_destination.push_back(j);
+			grid->od_volume.push_back(volume_distribution(generator));
+		}
+	}
+
+	// Parameter rows in the order of the user cost and assignment data files
+	grid->user_cost_values = { -1, 0.01, 3, 1.0, 2.0, 3.0 };
+	grid->assignment_values = { 0.01, 0.01, 0.01, 20, 2, 4.0, 7.0 / 6.0 };
+
+	return grid;
+}
+
+/**
+Times repeated runs of a benchmark.
+
+Requires the number of timed repetitions and the function to run.
+
+Returns the wall time of each timed repetition in seconds. The function is run once untimed beforehand to warm up.
+*/
+vector<double> time_runs(int repetitions, const function<void()> &body)
+{
+	vector<double> times;
+
+	body();
+	for (int i = 0; i < repetitions; i++)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		body();
+		times.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+	}
+
+	return times;
+}
+
+/// Writes a single row of benchmark results, consisting of the benchmark name, the instance and thread pool sizes, and the minimum, median, and mean wall times in seconds.
+void report(const string &name, int size, Network * net, vector<double> times)
+{
+	sort(times.begin(), times.end());
+	double mean = 0.0;
+	for (int i = 0; i < times.size(); i++)
+		mean += times[i] / times.size();
+
+	cout.clear();
+	cout << name << ',' << size << ',' << net->core_nodes.size() << ',' << net->core_arcs.size() << ',' << net->od_origin.size() << ',' << net->lines.size() << ',' << Pool->worker_count << ',' << times.size() << ',';
+	cout << times.front() << ',' << times[times.size() / 2] << ',' << mean << endl;
+	cout.setstate(ios_base::failbit);
+}
+
+/// Benchmark driver
+int main(int argc, char *argv[])
+{
+	// Read command line options
+	vector<int> sizes = { 4, 6, 8 };
+	vector<int> thread_counts = { 1, 2, 4 };
+	int repetitions = 5;
+	unsigned int seed = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-g") == 0) && (i + 1 < argc))
+			sizes = parse_list(argv[++i]);
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+			thread_counts = parse_list(argv[++i]);
+		else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+			repetitions = max(1, atoi(argv[++i]));
+		else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+			seed = atoi(argv[++i]);
+	}
+
+	// Keep the solution log in a scratch folder, so that no instance's log is touched
+	filesystem::path scratch = filesystem::temp_directory_path() / ("user_cost_benchmark_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+	filesystem::create_directories(scratch / "log");
+	FILE_BASE = scratch.string() + "/";
+
+	cout << "benchmark,grid,core_nodes,core_arcs,od_pairs,lines,threads,repetitions,min_seconds,median_seconds,mean_seconds" << endl;
+	cout << scientific << setprecision(6);
+	cout.setstate(ios_base::failbit);
+
+	for (int g = 0; g < sizes.size(); g++)
+	{
+		if (sizes[g] < 2)
+			continue;
+		InputData * grid = grid_instance(sizes[g], seed);
+
+		for (int t = 0; t < thread_counts.size(); t++)
+		{
+			// Build the instance around a new thread pool, so that every worker gets its own workspace
+			Pool = new ThreadPool(thread_counts[t]);
+			Search * Solver = new Search(new Network(new InputData(*grid)));
+			Network * Net = Solver->Net;
+			ConstantAssignment * Submodel = Solver->Con->Assignment->Submodel;
+			Solver->set_bounds();
+			Solver->Con->Log->sol_log.clear();
+			Solver->Con->Events->console = false; // keep progress lines out of the CSV output
+
+			// Arc frequencies of the initial solution
+			vector<double> freq(Net->core_arcs.size(), INFINITY);
+			for (int i = 0; i < Net->core_arcs.size(); i++)
+				if (Net->arc_type[i] == BOARDING_ARC)
+					freq[i] = Net->lines[Net->arc_line[i]]->frequency(Solver->sol_current[Net->arc_line[i]]);
+			pair<vector<double>, double> zero_flows(vector<double>(Net->core_arcs.size(), 0.0), 0.0);
+
+			// Single destination
+			if (Submodel->dest_order.empty() == false)
+			{
+				pair<vector<double>, double> flows = zero_flows;
+				report("destination", sizes[g], Net, time_runs(repetitions, [&]()
+				{
+					Submodel->flows_to_destination(Submodel->dest_order[0], flows.first, flows.second, freq, Net->arc_cost, Submodel->workspaces[0]);
+				}));
+			}
+
+			// Constant-cost model
+			report("constant", sizes[g], Net, time_runs(repetitions, [&]()
+			{
+				Submodel->calculate(Solver->sol_current, Net->arc_cost);
+			}));
+
+			// Nonlinear model
+			report("nonlinear", sizes[g], Net, time_runs(repetitions, [&]()
+			{
+				int iterations;
+				Solver->Con->Assignment->calculate(Solver->sol_current, zero_flows, iterations);
+			}));
+
+			// Neighborhood search, starting from the evaluated initial solution
+			Solver->obj_current = Solver->Con->calculate(Solver->sol_current, zero_flows, Solver->flows_current);
+			report("neighbor", sizes[g], Net, time_runs(repetitions, [&]()
+			{
+				Solver->Con->Log->sol_log.clear();
+				Solver->best_neighbor();
+			}));
+
+			delete Solver;
+			delete Pool;
+			Pool = nullptr;
+		}
+
+		delete grid;
+	}
+
+	filesystem::remove_all(scratch);
+
+	return SUCCESSFUL_EXIT;
+}
@@ -0,0 +1,116 @@
+/**
+Batch evaluation of the conical congestion function.
+
+The nonlinear assignment model evaluates the cost of every core arc at least once per Frank-Wolfe iteration. This kernel evaluates the costs of a whole array of arcs at once from contiguous flow, capacity, and base cost arrays, using AVX-512 or AVX2 instructions when the compiler targets them (for example with -march=native) and plain scalar code otherwise.
+
+Arcs with infinite capacity or zero flow keep their base cost, and arcs with zero capacity are given a very large cost. Rather than branching on these cases, every vectorized lane evaluates the conical function and the special cases are then substituted through masks. All paths perform the same operations in the same order, so they give bit-identical costs.
+
+The kernel is defined in this header so that it can be inlined into the assignment model's loops.
+*/
+
+#pragma once
+
+#include <cmath>
+#include "DEFINITIONS.hpp"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/**
+Calculates the conical congestion cost of a single arc.
+
+Requires the arc's flow, capacity, and base cost, the alpha parameter, the beta parameter, and the square of the beta parameter.
+
+Returns the arc's cost according to the conical congestion function, which is defined as:
+	c(x) = c * (2 + sqrt((alpha * (1 - x/u))^2 + beta^2) - alpha * (1 - x/u) - beta)
+where c(x) is the nonlinear cost, x is the arc's flow, c is the arc's base cost, and u is the arc's capacity.
+*/
+inline double conical_cost(double flow, double capacity, double base, double alpha, double beta, double beta_squared)
+{
+	// Return infinite cost for zero-capacity arcs
+	if (capacity == 0)
+		return LARGE;
+
+	// Return only the arc's base cost for infinite-capacity or zero-flow arcs
+	if ((capacity >= INFINITY) || (flow == 0))
+		return base;
+
+	double scaled = alpha * (1 - (flow / capacity));
+	return base * (2 + sqrt(scaled*scaled + beta_squared) - scaled - beta);
+}
+
+/**
+Calculates the conical congestion costs of an array of arcs.
+
+Requires the number of arcs, pointers to the beginning of the flow, capacity, and base cost arrays, the alpha and beta parameters, and a pointer to the beginning of the output cost array.
+
+Writes the cost of each arc into the output array.
+*/
+inline void conical_costs(int count, const double * flows, const double * capacities, const double * base, double alpha, double beta, double * costs)
+{
+	double beta_squared = beta * beta;
+	int i = 0;
+
+#if defined(__AVX512F__)
+	// Eight arcs at a time
+	const __m512d v_alpha = _mm512_set1_pd(alpha);
+	const __m512d v_beta = _mm512_set1_pd(beta);
+	const __m512d v_beta_squared = _mm512_set1_pd(beta_squared);
+	const __m512d v_one = _mm512_set1_pd(1.0);
+	const __m512d v_two = _mm512_set1_pd(2.0);
+	const __m512d v_zero = _mm512_setzero_pd();
+	const __m512d v_infinity = _mm512_set1_pd(INFINITY);
+	const __m512d v_large = _mm512_set1_pd(LARGE);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m512d flow = _mm512_loadu_pd(flows + i);
+		__m512d capacity = _mm512_loadu_pd(capacities + i);
+		__m512d cost = _mm512_loadu_pd(base + i);
+
+		__m512d scaled = _mm512_mul_pd(v_alpha, _mm512_sub_pd(v_one, _mm512_div_pd(flow, capacity)));
+		__m512d root = _mm512_sqrt_pd(_mm512_add_pd(_mm512_mul_pd(scaled, scaled), v_beta_squared));
+		__m512d value = _mm512_mul_pd(cost, _mm512_sub_pd(_mm512_sub_pd(_mm512_add_pd(v_two, root), scaled), v_beta));
+
+		// Substitute base costs for infinite-capacity or zero-flow arcs and large costs for zero-capacity arcs
+		__mmask8 plain = _mm512_cmp_pd_mask(capacity, v_infinity, _CMP_GE_OQ) | _mm512_cmp_pd_mask(flow, v_zero, _CMP_EQ_OQ);
+		value = _mm512_mask_blend_pd(plain, value, cost);
+		value = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(capacity, v_zero, _CMP_EQ_OQ), value, v_large);
+
+		_mm512_storeu_pd(costs + i, value);
+	}
+#elif defined(__AVX2__)
+	// Four arcs at a time
+	const __m256d v_alpha = _mm256_set1_pd(alpha);
+	const __m256d v_beta = _mm256_set1_pd(beta);
+	const __m256d v_beta_squared = _mm256_set1_pd(beta_squared);
+	const __m256d v_one = _mm256_set1_pd(1.0);
+	const __m256d v_two = _mm256_set1_pd(2.0);
+	const __m256d v_zero = _mm256_setzero_pd();
+	const __m256d v_infinity = _mm256_set1_pd(INFINITY);
+	const __m256d v_large = _mm256_set1_pd(LARGE);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d flow = _mm256_loadu_pd(flows + i);
+		__m256d capacity = _mm256_loadu_pd(capacities + i);
+		__m256d cost = _mm256_loadu_pd(base + i);
+
+		__m256d scaled = _mm256_mul_pd(v_alpha, _mm256_sub_pd(v_one, _mm256_div_pd(flow, capacity)));
+		__m256d root = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(scaled, scaled), v_beta_squared));
+		__m256d value = _mm256_mul_pd(cost, _mm256_sub_pd(_mm256_sub_pd(_mm256_add_pd(v_two, root), scaled), v_beta));
+
+		// Substitute base costs for infinite-capacity or zero-flow arcs and large costs for zero-capacity arcs
+		__m256d plain = _mm256_or_pd(_mm256_cmp_pd(capacity, v_infinity, _CMP_GE_OQ), _mm256_cmp_pd(flow, v_zero, _CMP_EQ_OQ));
+		value = _mm256_blendv_pd(value, cost, plain);
+		value = _mm256_blendv_pd(value, v_large, _mm256_cmp_pd(capacity, v_zero, _CMP_EQ_OQ));
+
+		_mm256_storeu_pd(costs + i, value);
+	}
+#endif
+
+	// Remaining arcs (or all arcs, without vector instructions)
+	for (; i < count; i++)
+		costs[i] = conical_cost(flows[i], capacities[i], base[i], alpha, beta, beta_squared);
+}
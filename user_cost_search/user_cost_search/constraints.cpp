@@ -1,101 +1,121 @@
 #include "constraints.hpp"
 
-/// Constraint object constructor that loads constraint file input and sets a network object pointer.
+/// Constraint object constructor that takes the user cost weights from the network's input data and sets a network object pointer.
 Constraint::Constraint(Network * net_in)
 {
 	Net = net_in;
 	stop_size = Net->stop_nodes.size();
-	sol_pair.first.resize(Net->core_arcs.size(), 0.0);
 
-	// Initialize assignment model object
+	// Initialize assignment model, solution log, and evaluation log objects
 	Assignment = new NonlinearAssignment(net_in);
+	Log = new SolutionLog(Net->lines.size(), Net->Input->source_stamps(false));
+	Events = new EvaluationLog();
 
-	// Read constraint data
-	ifstream us_file;
-	us_file.open(FILE_BASE + USER_COST_FILE);
-	if (us_file.is_open())
+	// Get user cost weights from the rows of the user cost data
+	vector<double> &values = Net->Input->user_cost_values;
+	if (values.size() < USER_COST_ROWS)
 	{
-		string line, piece; // whole line and line element being read
-		getline(us_file, line); // skip comment line
-		int count = 0;
-
-		while (us_file.eof() == false)
-		{
-			count++;
-
-			// Get whole line as a string stream
-			getline(us_file, line);
-			if (line.size() == 0)
-				// Break for blank line at file end
-				break;
-			stringstream stream(line);
-
-			// Go through each piece of the line
-			getline(stream, piece, '\t'); // Label
-			getline(stream, piece, '\t'); // Value
-			string value = piece;
-
-			// Expected data
-			if (count == 4)
-				riding_weight = stod(value);
-			if (count == 5)
-				walking_weight = stod(value);
-			if (count == 6)
-				waiting_weight = stod(value);
-		}
-
-		us_file.close();
-	}
-	else
-	{
-		cout << "Constraint file failed to open." << endl;
+		cout << "Constraint file is missing user cost weights." << endl;
 		cin.get();
-		exit(FILE_NOT_FOUND);
+		exit(INCORRECT_FILE);
 	}
+	riding_weight = values[3];
+	walking_weight = values[4];
+	waiting_weight = values[5];
 }
 
-/// Constraint object destructor deletes the nonlinear model object created by the constructor.
+/// Constraint object destructor deletes the nonlinear model, solution log, and evaluation log objects created by the constructor.
 Constraint::~Constraint()
 {
 	delete Assignment;
+	delete Log;
+	delete Events;
 }
 
 /**
 Evaluates the constraint functions for a given solution.
 
-Requires a solution vector.
+Requires a solution vector, an initial flow vector/waiting time pair to warm start the assignment model, and a reference to a flow vector/waiting time pair to hold the assignment model's converged solution.
 
 Returns the value of the user cost function.
+
+The solution log is consulted first. If the solution has already been logged its user cost is returned immediately and the output flow vector is left empty, since only the user cost components are logged. Otherwise the solution is fully evaluated and added to the log.
+
+Every outcome is also queued for the evaluation log, whose background thread writes it out without delaying the caller.
 */
-double Constraint::calculate(const vector<int> &sol)
+double Constraint::calculate(const vector<int> &sol, const pair<vector<double>, double> &warm_start, pair<vector<double>, double> &sol_pair)
+{
+	string sol_string = vec2str(sol);
+	vector<double> ucc; // user cost components
+	PROFILE_COUNT(COUNT_CANDIDATES, 1);
+
+	// Look up solution in the solution log
+	if (Log->lookup(sol_string, ucc) == true)
+	{
+		PROFILE_COUNT(COUNT_LOG_HITS, 1);
+		sol_pair.first.clear();
+		sol_pair.second = 0.0;
+		double obj = user_cost(ucc);
+		Events->evaluation(sol_string, RECORD_LOGGED, obj, 0, 0.0, FEAS_UNKNOWN);
+		return obj;
+	}
+
+	// Evaluate and log new solution
+	chrono::steady_clock::time_point start = chrono::steady_clock::now(); // evaluation timer
+	int iterations; // number of Frank-Wolfe iterations
+	ucc = evaluate(sol, warm_start, sol_pair, iterations);
+	double time = chrono::duration<double>(chrono::steady_clock::now() - start).count(); // evaluation time
+	Log->record(sol_string, FEAS_UNKNOWN, ucc, time);
+	double obj = user_cost(ucc);
+	Events->evaluation(sol_string, RECORD_EVALUATED, obj, iterations, time, FEAS_UNKNOWN);
+
+	return obj;
+}
+
+/**
+Solves the assignment model for a given solution, without consulting the solution log.
+
+Requires a solution vector, an initial flow vector/waiting time pair to warm start the assignment model, a reference to a flow vector/waiting time pair to hold the assignment model's converged solution, and a reference to an integer to hold the number of Frank-Wolfe iterations performed.
+
+Returns a vector of the user cost components.
+
+The warm start is typically the converged assignment of a neighboring solution, which usually lies close to the new solution's assignment and so reduces the number of Frank-Wolfe iterations required.
+*/
+vector<double> Constraint::evaluate(const vector<int> &sol, const pair<vector<double>, double> &warm_start, pair<vector<double>, double> &sol_pair, int &iterations)
 {
 	// Feed solution to assignment model to calculate flow vector
-	sol_pair = Assignment->calculate(sol, sol_pair);
+	sol_pair = Assignment->calculate(sol, warm_start, iterations);
 
 	// Calculate user cost components
-	vector<double> ucc = user_cost_components();
+	return user_cost_components(sol_pair);
+}
 
-	// Return total user cost
+/// Returns the total user cost as a weighted sum of the user cost components.
+double Constraint::user_cost(const vector<double> &ucc)
+{
 	return riding_weight*ucc[0] + walking_weight*ucc[1] + waiting_weight*ucc[2];
 }
 
 /**
 Converts user flow vector and waiting time scalar into a vector of the user cost components.
 
+Requires a flow vector/waiting time pair.
+
 Returns a vector of the user cost components, in the order of the solution log columns.
 */
-vector<double> Constraint::user_cost_components()
+vector<double> Constraint::user_cost_components(const pair<vector<double>, double> &sol_pair)
 {
 	vector<double> uc(UC_COMPONENTS, 0.0);
 	uc[2] = sol_pair.second;
 
-	// In-vehicle riding time
-	for (int i = 0; i < Net->line_arcs.size(); i++)
-		uc[0] += sol_pair.first[Net->line_arcs[i]->id] * Net->line_arcs[i]->cost;
-
-	// Walking time
-	for (int i = 0; i < Net->walking_arcs.size(); i++)
-		uc[1] += sol_pair.first[Net->walking_arcs[i]->id] * Net->walking_arcs[i]->cost;
+	// In-vehicle riding time and walking time
+	for (int i = 0; i < Net->core_arcs.size(); i++)
+	{
+		if (Net->arc_type[i] == LINE_ARC)
+			uc[0] += sol_pair.first[i] * Net->arc_cost[i];
+		else if (Net->arc_type[i] == WALKING_ARC)
+			uc[1] += sol_pair.first[i] * Net->arc_cost[i];
+	}
 
 	return uc;
 }
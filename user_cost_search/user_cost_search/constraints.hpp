@@ -6,6 +6,7 @@ Includes a variety of functions for calculating the constraint function values f
 
 #pragma once
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -15,17 +16,19 @@ Includes a variety of functions for calculating the constraint function values f
 #include "DEFINITIONS.hpp"
 #include "network.hpp"
 #include "assignment.hpp"
+#include "evaluation_log.hpp"
+#include "solution_log.hpp"
 
 using namespace std;
 
-extern string FILE_BASE;
+extern thread_local string FILE_BASE;
 
 /**
 Constraint function class.
 
 A variety of local attributes are used to store information required for calculating the constraint functions
 
-Methods are used to execute different steps of the constraint function calculation process, which in turn requires the use of the assignment model.
+Methods are used to execute different steps of the constraint function calculation process, which in turn requires the use of the assignment model. No state is kept between evaluations apart from the solution log, so several solutions may be evaluated concurrently.
 
 NOTE: Currently leaving out the operator cost function, since it is irrelevant to our model.
 */
@@ -34,7 +37,8 @@ struct Constraint
 	// Public attributes
 	Network * Net; // pointer to the main transit network object
 	NonlinearAssignment * Assignment; // pointer to the assignment model object
-	pair<vector<double>, double> sol_pair; // flow vector/waiting time pair produced by assignment model
+	SolutionLog * Log; // pointer to the solution log object
+	EvaluationLog * Events; // pointer to the asynchronous evaluation log object
 	double riding_weight; // user cost weight for in-vehicle travel time
 	double walking_weight; // user cost weight for walking time
 	double waiting_weight; // user cost weight for waiting time
@@ -42,7 +46,9 @@ struct Constraint
 
 	// Public methods
 	Constraint(Network *); // constructor that reads the operator cost, user cost, initial flow, and assignment model data and sets the network object pointer
-	~Constraint(); // destructor deletes the assignment model object
-	double calculate(const vector<int> &); // evaluates constraint functions for a given solution
-	vector<double> user_cost_components(); // uses flow vector and waiting time scalar to calculate user cost components
+	~Constraint(); // destructor deletes the assignment model, solution log, and evaluation log objects
+	double calculate(const vector<int> &, const pair<vector<double>, double> &, pair<vector<double>, double> &); // evaluates constraint functions for a given solution and warm start, consulting the solution log first, and outputs the converged assignment solution if one was found
+	vector<double> evaluate(const vector<int> &, const pair<vector<double>, double> &, pair<vector<double>, double> &, int &); // solves the assignment model for a given solution and warm start, and outputs the converged assignment solution, the number of Frank-Wolfe iterations, and the user cost components
+	double user_cost(const vector<double> &); // combines user cost components into the total user cost
+	vector<double> user_cost_components(const pair<vector<double>, double> &); // uses flow vector and waiting time scalar to calculate user cost components
 };
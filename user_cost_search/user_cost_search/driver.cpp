@@ -3,34 +3,83 @@ The main function for the search algorithm, modified to run as a user cost-optim
 
 Responsible for reading input data, initializing objects, and finally calling the search function, which is where most of the algorithm is actually conducted.
 
-The exit code should correspond to the circumstances of the exit.
+The exit code should correspond to the circumstances of the exit. An unrecognized command line option exits with INCORRECT_OPTION before any data is read.
+
+SIGINT and SIGTERM stop the search after saving a checkpoint to the log/ folder, and the next run resumes from it. The exit code is then SEARCH_INTERRUPTED.
+
+Command line options:
+	-t <threads>: number of worker threads to use (default 0, meaning one per hardware thread)
+	-c: compile the data files into a binary snapshot and exit without searching (later runs load the snapshot until any data file changes)
 */
 
 #include <csignal>
+#include <cstring>
 #include <iostream>
 #include "DEFINITIONS.hpp"
+#include "input_data.hpp"
 #include "search.hpp"
+#include "thread_pool.hpp"
 
 using namespace std;
 
 // Global search object pointer
 Search * Solver;
 
+// Global thread pool pointer
+ThreadPool * Pool;
+
 // Global file base name
-string FILE_BASE = "";
+thread_local string FILE_BASE = "";
 
 /// Main driver
-int main()
+int main(int argc, char *argv[])
 {
+	// Read command line options
+	int threads = DEFAULT_THREADS;
+	bool compile = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+			threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-c") == 0)
+			compile = true;
+		else
+		{
+			cout << "Unrecognized option " << argv[i] << "." << endl;
+			return INCORRECT_OPTION;
+		}
+	}
+
+	// Initialize worker threads
+	Pool = new ThreadPool(threads);
+
+	// Compile data snapshot, if requested
+	if (compile == true)
+	{
+		InputData data;
+		int code = SUCCESSFUL_EXIT;
+		if (data.read_text() == false)
+			code = INCORRECT_FILE;
+		else if (data.write_snapshot() == false)
+			code = WRITE_FAILED;
+		delete Pool;
+		return code;
+	}
+
 	// Initialize search object
 	Solver = new Search();
 
-	// Call main solver
+	// Call main solver, stopping at a checkpoint if interrupted
+	signal(SIGINT, interrupt_search);
+	signal(SIGTERM, interrupt_search);
 	Solver->solve();
 
 	// Delete solver to automate shutdown process
 	delete Solver;
+	delete Pool;
 
+	if (Interrupted == true)
+		return SEARCH_INTERRUPTED;
 	cin.get();
 	return SUCCESSFUL_EXIT;
 }
@@ -0,0 +1,165 @@
+/// Evaluation log class methods.
+
+#include "evaluation_log.hpp"
+
+// Names of the evaluation record types, in type order
+static const char * SOURCE_NAMES[RECORD_MESSAGE] = { "evaluated", "logged" };
+
+/**
+Evaluation log constructor opens the evaluation log file and starts the background thread.
+
+The file is overwritten, so that it only covers the current run. Unlike the solution log it is never read back in.
+*/
+EvaluationLog::EvaluationLog()
+{
+	log_file.open(FILE_BASE + EVALUATION_LOG_FILE);
+	if (log_file.is_open() == true)
+		log_file << "Solution\tSource\tObjective\tFW_Iterations\tSeconds\tFeasible" << endl;
+	else
+		cout << "Failed to open evaluation log." << endl;
+	log_file << fixed << setprecision(15);
+
+	console = true;
+	start_time = chrono::steady_clock::now();
+	last_progress = start_time;
+	writer = thread(&EvaluationLog::writer_loop, this);
+}
+
+/// Evaluation log destructor tells the background thread to write all remaining records, waits for it to exit, and closes the file.
+EvaluationLog::~EvaluationLog()
+{
+	{
+		lock_guard<mutex> guard(queue_lock);
+		stopping = true;
+	}
+	not_empty.notify_one();
+	writer.join();
+	log_file.close();
+}
+
+/**
+Adds a record to the queue.
+
+Requires a record, which is moved into the queue.
+
+If the queue is already full then the calling thread waits until the background thread has taken its records.
+*/
+void EvaluationLog::push(LogRecord &&record)
+{
+	{
+		unique_lock<mutex> guard(queue_lock);
+		not_full.wait(guard, [this] { return queue.size() < EVALUATION_QUEUE_SIZE; });
+		queue.push_back(move(record));
+	}
+	not_empty.notify_one();
+}
+
+/**
+Queues the record of a single candidate evaluation.
+
+Requires the candidate's solution string, the record type (RECORD_EVALUATED or RECORD_LOGGED), its objective value, the number of Frank-Wolfe iterations used, the wall time of the evaluation, and its feasibility status.
+*/
+void EvaluationLog::evaluation(const string &sol, int type, double objective, int iterations, double seconds, int feasibility)
+{
+	push(LogRecord{ type, sol, objective, iterations, seconds, feasibility });
+}
+
+/// Queues a console message, which is printed as its own line.
+void EvaluationLog::message(const string &text)
+{
+	push(LogRecord{ RECORD_MESSAGE, text, 0.0, 0, 0.0, FEAS_UNKNOWN });
+}
+
+/// Waits until the background thread has written every record queued before the call.
+void EvaluationLog::flush()
+{
+	unique_lock<mutex> guard(queue_lock);
+	idle.wait(guard, [this] { return (queue.empty() == true) && (writing == false); });
+}
+
+/**
+Main loop of the background thread.
+
+Takes every waiting record from the queue at once, so that the lock is released while they are written. The console and file are flushed once per batch, rather than after every record. While no records arrive the thread still wakes once per progress interval, so that the progress line keeps up with evaluations that have already been written.
+
+Exits once told to stop and the queue is empty, after printing a final progress line.
+*/
+void EvaluationLog::writer_loop()
+{
+	deque<LogRecord> batch; // records taken from the queue
+	while (true)
+	{
+		{
+			unique_lock<mutex> guard(queue_lock);
+			writing = false;
+			if (queue.empty() == true)
+				idle.notify_all();
+			not_empty.wait_for(guard, chrono::duration<double>(PROGRESS_INTERVAL), [this] { return (queue.empty() == false) || (stopping == true); });
+			if ((queue.empty() == true) && (stopping == true))
+				break;
+			batch.swap(queue);
+			writing = true;
+		}
+		not_full.notify_all();
+
+		// Write the batch, and print a progress line if enough time has passed
+		for (int i = 0; i < batch.size(); i++)
+			write(batch[i]);
+		batch.clear();
+		if (chrono::duration<double>(chrono::steady_clock::now() - last_progress).count() >= PROGRESS_INTERVAL)
+			progress();
+		cout.flush();
+		log_file.flush();
+	}
+
+	progress();
+	cout.flush();
+	log_file.flush();
+	idle.notify_all();
+}
+
+/**
+Writes a single record.
+
+Requires a record.
+
+Console messages are printed, while evaluations are appended to the evaluation log file and added to the totals reported by the progress line.
+*/
+void EvaluationLog::write(const LogRecord &record)
+{
+	if (record.type == RECORD_MESSAGE)
+	{
+		if (console == true)
+			cout << record.text << '\n';
+		return;
+	}
+
+	counts[record.type]++;
+	if (record.objective < best_objective)
+		best_objective = record.objective;
+	if (log_file.is_open() == true)
+		log_file << record.text << '\t' << SOURCE_NAMES[record.type] << '\t' << record.objective << '\t' << record.iterations << '\t' << record.seconds << '\t' << record.feasibility << '\n';
+}
+
+/**
+Prints a progress line.
+
+The line gives the time since the log was created, the number of candidates evaluated and found in the solution log, the best objective value seen, and the rate of candidates handled since the previous progress line. Nothing is printed if no candidates have been handled since then.
+*/
+void EvaluationLog::progress()
+{
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	long long total = counts[RECORD_EVALUATED] + counts[RECORD_LOGGED];
+	if ((total == last_total) || (console == false))
+		return;
+	double rate = (total - last_total) / chrono::duration<double>(now - last_progress).count(); // candidates per second since the last progress line
+
+	ostringstream line;
+	line << fixed << setprecision(1) << '[' << chrono::duration<double>(now - start_time).count() << " s] ";
+	line << counts[RECORD_EVALUATED] << " evaluated, " << counts[RECORD_LOGGED] << " logged, ";
+	line << "best " << setprecision(6) << best_objective << ", " << setprecision(1) << rate << " candidates/s";
+	cout << line.str() << '\n';
+
+	last_total = total;
+	last_progress = now;
+}
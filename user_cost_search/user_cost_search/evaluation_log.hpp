@@ -0,0 +1,88 @@
+/**
+Asynchronous evaluation log.
+
+Keeps console and file output off the hot path of the search. Worker threads hand records to a bounded queue, and a single background thread writes them out. Every candidate evaluation becomes one line of the evaluation log file, and the search's own messages (such as the move made in each iteration) are printed to the console. In place of per-evaluation console output, the background thread prints a progress line summarizing the evaluations at most once per progress interval.
+
+If the queue is full then the thread adding a record waits for room, so the memory used by the log stays bounded no matter how quickly records arrive.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "DEFINITIONS.hpp"
+
+#define EVALUATION_LOG_FILE "log/evaluation_log.txt" // evaluation log output file
+#define EVALUATION_QUEUE_SIZE 4096 // largest number of records waiting to be written
+#define PROGRESS_INTERVAL 2.0 // smallest number of seconds between progress lines
+
+// Record types
+#define RECORD_EVALUATED 0 // candidate whose assignment model was solved
+#define RECORD_LOGGED 1 // candidate found in the solution log
+#define RECORD_MESSAGE 2 // console message
+
+using namespace std;
+
+extern thread_local string FILE_BASE;
+
+// Structure declarations
+struct LogRecord;
+struct EvaluationLog;
+
+/// A single queued record, which is either a candidate evaluation or a console message.
+struct LogRecord
+{
+	// Public attributes
+	int type; // record type
+	string text; // solution string of an evaluation, or the text of a message
+	double objective; // objective value of an evaluation
+	int iterations; // number of Frank-Wolfe iterations of an evaluation
+	double seconds; // wall time of an evaluation
+	int feasibility; // feasibility status of an evaluation
+};
+
+/**
+Evaluation log class.
+
+The background thread is started by the constructor and stopped by the destructor, which first writes every remaining record along with a final progress line. Console messages are written in the order in which they were queued, so any thread which prints to the console directly should first wait for the queue to be flushed.
+*/
+struct EvaluationLog
+{
+	// Public attributes
+	deque<LogRecord> queue; // records waiting to be written
+	mutex queue_lock; // lock for the queue and the stopping flag
+	condition_variable not_empty; // signal used to wake the background thread when records arrive or the log is stopping
+	condition_variable not_full; // signal used to wake threads waiting for room in the queue
+	condition_variable idle; // signal used to wake threads waiting for all queued records to be written
+	bool writing = false; // whether the background thread is writing records taken from the queue
+	bool stopping = false; // whether the background thread has been told to exit
+	atomic<bool> console; // whether messages and progress lines are printed (evaluations are always written to the file)
+	thread writer; // background thread
+	ofstream log_file; // evaluation log file
+	chrono::steady_clock::time_point start_time; // time at which the log was created
+	chrono::steady_clock::time_point last_progress; // time of the last progress line
+	long long counts[RECORD_MESSAGE] = {}; // number of evaluations of each type written so far
+	long long last_total = 0; // number of evaluations written at the time of the last progress line
+	double best_objective = INFINITY; // smallest objective value of any fully evaluated candidate
+
+	// Public methods
+	EvaluationLog(); // constructor opens the evaluation log file and starts the background thread
+	~EvaluationLog(); // destructor writes all remaining records and stops the background thread
+	void push(LogRecord &&); // adds a record to the queue, waiting if it is full
+	void evaluation(const string &, int, double, int, double, int); // queues an evaluation record
+	void message(const string &); // queues a console message
+	void flush(); // waits until every queued record has been written
+	void writer_loop(); // main loop of the background thread
+	void write(const LogRecord &); // writes a single record
+	void progress(); // prints a progress line
+};
@@ -0,0 +1,78 @@
+/**
+The main function for the instance generator, which writes a randomly generated example instance in the format expected by the user cost search.
+
+Any generation parameter (see instance_generator.hpp for the full list and their defaults) can be changed with a name=value argument. For example, "instance_generator -o big/ hlines=30 vlines=30 populations=200" generates a much larger instance in the big/ folder.
+
+Command line options:
+	-o <folder>: instance folder, which receives the data/ and log/ subfolders (default is the working directory)
+	-s <seed>: random seed (default 1)
+	-t <threads>: number of worker threads to use (default 0, meaning one per hardware thread)
+	<name>=<value>: sets a generation parameter
+*/
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "DEFINITIONS.hpp"
+#include "instance_generator.hpp"
+#include "thread_pool.hpp"
+
+using namespace std;
+
+// Global thread pool pointer
+ThreadPool * Pool;
+
+/// Generator driver
+int main(int argc, char *argv[])
+{
+	// Read command line options
+	InstanceGenerator Generator;
+	string folder = "";
+	int threads = DEFAULT_THREADS;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+		{
+			folder = argv[++i];
+			if ((folder.empty() == false) && (folder.back() != '/'))
+				folder += '/';
+		}
+		else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+			Generator.seed = atoi(argv[++i]);
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+			threads = atoi(argv[++i]);
+		else
+		{
+			string argument = argv[i];
+			size_t split = argument.find('=');
+			bool known = false;
+			if ((split != string::npos) && (split + 1 < argument.size()))
+			{
+				try
+				{
+					known = Generator.set_parameter(argument.substr(0, split), stod(argument.substr(split + 1)));
+				}
+				catch (const exception &)
+				{
+					known = false;
+				}
+			}
+			if (known == false)
+			{
+				cout << "Unrecognized option " << argument << "." << endl;
+				return INCORRECT_OPTION;
+			}
+		}
+	}
+
+	// Initialize worker threads
+	Pool = new ThreadPool(threads);
+
+	// Generate instance
+	int code = SUCCESSFUL_EXIT;
+	if (Generator.generate(folder) == false)
+		code = WRITE_FAILED;
+
+	delete Pool;
+	return code;
+}
@@ -0,0 +1,264 @@
+/// Input data class methods.
+
+#include "input_data.hpp"
+
+#define SNAPSHOT_SOURCES 8 // number of input data files included in the snapshot
+#define SNAPSHOT_ORDER 0x01020304 // byte order mark, used to reject snapshots written on a machine of different endianness
+
+// Magic number at the beginning of every snapshot file
+static const char SNAPSHOT_MAGIC[8] = { 'U', 'C', 'S', 'N', 'A', 'P', '\0', '\0' };
+
+/// Fixed-size header at the beginning of every snapshot file.
+struct SnapshotHeader
+{
+	char magic[8]; // magic number
+	uint32_t version; // snapshot format version
+	uint32_t order; // byte order mark
+	uint64_t payload_size; // number of bytes following the header
+	uint64_t payload_checksum; // checksum of the bytes following the header
+	int64_t stamps[2 * SNAPSHOT_SOURCES]; // size and modification time of each input data file
+};
+
+/// Returns the 64-bit FNV-1a hash of a byte array.
+uint64_t checksum(const char * data, size_t size)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= (unsigned char) data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+Loads all input data.
+
+The snapshot is used if it exists and is up to date. Otherwise the text files are read.
+
+Returns true if the data were loaded successfully.
+*/
+bool InputData::load()
+{
+	if (read_snapshot() == true)
+		return true;
+	return read_text();
+}
+
+/**
+Reads all input data text files.
+
+Returns true if every file was read successfully. Otherwise prints a description of the first problem (including the file and line number of any malformed row), keeps it as the error string, and returns false.
+*/
+bool InputData::read_text()
+{
+	TsvReader reader;
+	vector<double> problem_values; // value on each row of the problem data file
+	vector<int> od_origin_all; // origin node ID of each O/D pair
+	vector<int> od_destination_all; // destination node ID of each O/D pair
+	vector<double> od_volume_all; // travel volume of each O/D pair
+
+	bool success = reader.read(FILE_BASE + PROBLEM_FILE, { {1, "Value", nullptr, &problem_values} })
+		&& reader.read(FILE_BASE + NODE_FILE, { {0, "ID", &node_id, nullptr}, {2, "Type", &node_type, nullptr}, {4, "Value", nullptr, &node_value} })
+		&& reader.read(FILE_BASE + VEHICLE_FILE, { {2, "UB", &vehicle_bound, nullptr}, {3, "Seating", nullptr, &vehicle_capacity} })
+		&& reader.read(FILE_BASE + TRANSIT_FILE, { {2, "Type", &line_type, nullptr}, {3, "Fleet", &line_fleet, nullptr}, {4, "Circuit", nullptr, &line_circuit}, {5, "Scaling", nullptr, &line_scaling}, {6, "LB", &line_lb, nullptr}, {7, "UB", &line_ub, nullptr} })
+		&& reader.read(FILE_BASE + ARC_FILE, { {0, "ID", &arc_id, nullptr}, {1, "Type", &arc_type, nullptr}, {2, "Line", &arc_line, nullptr}, {3, "Tail", &arc_tail, nullptr}, {4, "Head", &arc_head, nullptr}, {5, "Time", nullptr, &arc_time} })
+		&& reader.read(FILE_BASE + OD_FILE, { {1, "Origin", &od_origin_all, nullptr}, {2, "Destination", &od_destination_all, nullptr}, {3, "Volume", nullptr, &od_volume_all} })
+		&& reader.read(FILE_BASE + USER_COST_FILE, { {1, "Value", nullptr, &user_cost_values} })
+		&& reader.read(FILE_BASE + ASSIGNMENT_FILE, { {1, "Value", nullptr, &assignment_values} });
+	if (success == false)
+	{
+		error = reader.error;
+		cout << error << endl;
+		return false;
+	}
+
+	// Get time horizon from the second row of the problem file
+	if (problem_values.size() < 2)
+	{
+		error = FILE_BASE + PROBLEM_FILE + " has no time horizon row.";
+		cout << error << endl;
+		return false;
+	}
+	horizon = problem_values[1];
+
+	// Keep only the nonzero travel volumes
+	for (int i = 0; i < od_volume_all.size(); i++)
+	{
+		if (od_volume_all[i] != 0)
+		{
+			od_origin.push_back(od_origin_all[i]);
+			od_destination.push_back(od_destination_all[i]);
+			od_volume.push_back(od_volume_all[i]);
+		}
+	}
+
+	return true;
+}
+
+/**
+Reads the snapshot file.
+
+Returns true if the snapshot was read, and false if it is missing, was written by a different version or on a different kind of machine, is out of date with respect to any data file, or is corrupted. Nothing is changed unless the snapshot is read successfully.
+*/
+bool InputData::read_snapshot()
+{
+	MappedFile snapshot;
+	if (snapshot.open(FILE_BASE + SNAPSHOT_FILE) == false)
+		return false;
+
+	// Check header
+	SnapshotHeader header;
+	if (snapshot.size < sizeof(header))
+	{
+		cout << "Snapshot is incomplete. Reading data files instead." << endl;
+		return false;
+	}
+	memcpy(&header, snapshot.data, sizeof(header));
+	if ((memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) || (header.version != SNAPSHOT_VERSION) || (header.order != SNAPSHOT_ORDER))
+	{
+		cout << "Snapshot is from a different version. Reading data files instead." << endl;
+		return false;
+	}
+	vector<int64_t> stamps = source_stamps();
+	for (int i = 0; i < stamps.size(); i++)
+	{
+		if (header.stamps[i] != stamps[i])
+		{
+			cout << "Snapshot is out of date. Reading data files instead." << endl;
+			return false;
+		}
+	}
+	const char * payload = snapshot.data + sizeof(header);
+	size_t size = snapshot.size - sizeof(header);
+	if ((header.payload_size != size) || (header.payload_checksum != checksum(payload, size)))
+	{
+		cout << "Snapshot is corrupted. Reading data files instead." << endl;
+		return false;
+	}
+
+	// Copy arrays into a new object, so that nothing changes if the payload is malformed
+	InputData loaded;
+	vector<double> horizon_array;
+	size_t position = 0;
+	bool complete = get_array(payload, size, position, horizon_array) && (horizon_array.size() == 1)
+		&& get_array(payload, size, position, loaded.node_id) && get_array(payload, size, position, loaded.node_type) && get_array(payload, size, position, loaded.node_value)
+		&& get_array(payload, size, position, loaded.vehicle_bound) && get_array(payload, size, position, loaded.vehicle_capacity)
+		&& get_array(payload, size, position, loaded.line_type) && get_array(payload, size, position, loaded.line_fleet) && get_array(payload, size, position, loaded.line_circuit)
+		&& get_array(payload, size, position, loaded.line_scaling) && get_array(payload, size, position, loaded.line_lb) && get_array(payload, size, position, loaded.line_ub)
+		&& get_array(payload, size, position, loaded.arc_id) && get_array(payload, size, position, loaded.arc_type) && get_array(payload, size, position, loaded.arc_line)
+		&& get_array(payload, size, position, loaded.arc_tail) && get_array(payload, size, position, loaded.arc_head) && get_array(payload, size, position, loaded.arc_time)
+		&& get_array(payload, size, position, loaded.od_origin) && get_array(payload, size, position, loaded.od_destination) && get_array(payload, size, position, loaded.od_volume)
+		&& get_array(payload, size, position, loaded.user_cost_values) && get_array(payload, size, position, loaded.assignment_values);
+	if (complete == false)
+	{
+		cout << "Snapshot is corrupted. Reading data files instead." << endl;
+		return false;
+	}
+	loaded.horizon = horizon_array[0];
+
+	*this = move(loaded);
+	cout << "Loaded data snapshot." << endl;
+	return true;
+}
+
+/**
+Writes the snapshot file.
+
+Returns true if the snapshot was written successfully.
+
+The snapshot is first written to a temporary file which then replaces the old snapshot, so that an interrupted write never leaves a partial snapshot behind.
+*/
+bool InputData::write_snapshot()
+{
+	// Gather payload
+	string payload;
+	put_array(payload, vector<double>(1, horizon));
+	put_array(payload, node_id);
+	put_array(payload, node_type);
+	put_array(payload, node_value);
+	put_array(payload, vehicle_bound);
+	put_array(payload, vehicle_capacity);
+	put_array(payload, line_type);
+	put_array(payload, line_fleet);
+	put_array(payload, line_circuit);
+	put_array(payload, line_scaling);
+	put_array(payload, line_lb);
+	put_array(payload, line_ub);
+	put_array(payload, arc_id);
+	put_array(payload, arc_type);
+	put_array(payload, arc_line);
+	put_array(payload, arc_tail);
+	put_array(payload, arc_head);
+	put_array(payload, arc_time);
+	put_array(payload, od_origin);
+	put_array(payload, od_destination);
+	put_array(payload, od_volume);
+	put_array(payload, user_cost_values);
+	put_array(payload, assignment_values);
+
+	// Fill header
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.order = SNAPSHOT_ORDER;
+	header.payload_size = payload.size();
+	header.payload_checksum = checksum(payload.data(), payload.size());
+	vector<int64_t> stamps = source_stamps();
+	for (int i = 0; i < stamps.size(); i++)
+		header.stamps[i] = stamps[i];
+
+	// Write temporary file and move it into place
+	string snapshot_name = FILE_BASE + SNAPSHOT_FILE;
+	ofstream snapshot_file(snapshot_name + ".tmp", ios_base::binary | ios_base::trunc);
+	if (snapshot_file.is_open() == false)
+	{
+		cout << "Failed to write snapshot." << endl;
+		return false;
+	}
+	snapshot_file.write((const char *) &header, sizeof(header));
+	snapshot_file.write(payload.data(), payload.size());
+	snapshot_file.close();
+	error_code error;
+	filesystem::rename(snapshot_name + ".tmp", snapshot_name, error);
+	if ((snapshot_file.fail() == true) || (error))
+	{
+		cout << "Failed to write snapshot." << endl;
+		return false;
+	}
+
+	cout << "Successfully wrote snapshot." << endl;
+	return true;
+}
+
+/**
+Finds the size and modification time of each input data file.
+
+Accepts an optional flag which, if false, leaves out the user cost file (default true).
+
+Returns a vector consisting of each file's size followed by its modification time, in the order of the snapshot header. Both are -1 for a missing or left out file.
+*/
+vector<int64_t> InputData::source_stamps(bool user_cost)
+{
+	string sources[SNAPSHOT_SOURCES] = { PROBLEM_FILE, NODE_FILE, VEHICLE_FILE, TRANSIT_FILE, ARC_FILE, OD_FILE, USER_COST_FILE, ASSIGNMENT_FILE };
+	vector<int64_t> stamps(2 * SNAPSHOT_SOURCES, -1);
+
+	for (int i = 0; i < SNAPSHOT_SOURCES; i++)
+	{
+		if ((user_cost == false) && (sources[i] == USER_COST_FILE))
+			continue;
+		error_code error;
+		filesystem::path source = FILE_BASE + sources[i];
+		uintmax_t size = filesystem::file_size(source, error);
+		if (error)
+			continue;
+		filesystem::file_time_type time = filesystem::last_write_time(source, error);
+		if (error)
+			continue;
+		stamps[2 * i] = size;
+		stamps[2 * i + 1] = time.time_since_epoch().count();
+	}
+
+	return stamps;
+}
@@ -0,0 +1,115 @@
+/**
+Contents of the input data files.
+
+Holds the raw contents of every input data file, which are used to build the network and to set the parameters of the search and the assignment model. The data are read from the text files in the data folder or, when one is available and up to date, from a compiled binary snapshot of those files.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "mapped_file.hpp"
+#include "tsv_reader.hpp"
+
+using namespace std;
+
+extern thread_local string FILE_BASE;
+
+// Global function prototypes
+uint64_t checksum(const char *, size_t); // returns the 64-bit FNV-1a hash of a byte array
+
+// Structure declarations
+struct InputData;
+
+/**
+Input data class.
+
+Each data file's rows are stored as a set of parallel arrays, one per column, in file order. Columns which are never used are not stored.
+
+The snapshot consists of a header followed by a payload of all arrays. The header includes a format version, the size and modification time of every data file that the snapshot was compiled from, and a checksum of the payload. A snapshot is only used if all of these match, and otherwise the text files are read instead. Since the payload's arrays are stored in their in-memory format, loading a snapshot amounts to mapping the file and copying each array in bulk, without any parsing.
+*/
+struct InputData
+{
+	// Public attributes (problem data)
+	double horizon = 1440.0; // daily time horizon (minutes)
+
+	// Public attributes (node data)
+	vector<int> node_id; // ID of each node
+	vector<int> node_type; // type ID of each node
+	vector<double> node_value; // value of each node
+
+	// Public attributes (vehicle data)
+	vector<int> vehicle_bound; // maximum fleet size of each vehicle type
+	vector<double> vehicle_capacity; // seating capacity of each vehicle type
+
+	// Public attributes (transit data)
+	vector<int> line_type; // vehicle type ID of each line
+	vector<int> line_fleet; // initial fleet size of each line
+	vector<double> line_circuit; // circuit time of each line
+	vector<double> line_scaling; // active fraction of day of each line
+	vector<int> line_lb; // lower fleet bound of each line
+	vector<int> line_ub; // upper fleet bound of each line
+
+	// Public attributes (arc data)
+	vector<int> arc_id; // ID of each arc
+	vector<int> arc_type; // type ID of each arc
+	vector<int> arc_line; // line ID of each arc
+	vector<int> arc_tail; // tail node ID of each arc
+	vector<int> arc_head; // head node ID of each arc
+	vector<double> arc_time; // constant travel time of each arc
+
+	// Public attributes (O/D data, with only the nonzero pairs included)
+	vector<int> od_origin; // origin node ID of each nonzero O/D pair
+	vector<int> od_destination; // destination node ID of each nonzero O/D pair
+	vector<double> od_volume; // travel volume of each nonzero O/D pair
+
+	// Public attributes (parameter data)
+	vector<double> user_cost_values; // value on each row of the user cost data file
+	vector<double> assignment_values; // value on each row of the assignment data file
+
+	// Public attributes (technical)
+	string error; // description of the problem which ended the last failed read of the text files
+
+	// Public methods
+	bool load(); // reads the snapshot if it is up to date, and otherwise reads the text files, returning whether it succeeded
+	bool read_text(); // reads all input data text files, returning whether it succeeded
+	bool read_snapshot(); // reads the snapshot file, returning whether it was present and up to date
+	bool write_snapshot(); // writes the snapshot file, returning whether it succeeded
+	vector<int64_t> source_stamps(bool = true); // returns the size and modification time of each input data file, optionally leaving out the user cost file
+};
+
+/// Appends an array to a binary payload (such as a snapshot or checkpoint), preceded by its length and padded to a multiple of 8 bytes so that every array remains aligned.
+template<class T>
+void put_array(string &payload, const vector<T> &values)
+{
+	uint64_t count = values.size();
+	payload.append((const char *) &count, sizeof(count));
+	payload.append((const char *) values.data(), count * sizeof(T));
+	payload.append((8 - payload.size() % 8) % 8, '\0');
+}
+
+/// Copies an array out of a binary payload beginning at a given position, and advances the position past it. Returns false if the payload ends too soon.
+template<class T>
+bool get_array(const char * payload, size_t size, size_t &position, vector<T> &values)
+{
+	uint64_t count;
+	if (position + sizeof(count) > size)
+		return false;
+	memcpy(&count, payload + position, sizeof(count));
+	position += sizeof(count);
+
+	if (count > (size - position) / sizeof(T))
+		return false;
+	values.resize(count);
+	memcpy(values.data(), payload + position, count * sizeof(T));
+	position += count * sizeof(T);
+	position += (8 - position % 8) % 8;
+
+	return true;
+}
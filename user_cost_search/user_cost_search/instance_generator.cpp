@@ -0,0 +1,776 @@
+/// Instance generator class methods.
+
+#include "instance_generator.hpp"
+
+/// Opens an output file for writing, printing a message and returning false if it cannot be opened.
+static bool open_output(ofstream &file, const string &name)
+{
+	file.open(name, ios_base::trunc);
+	if (file.is_open() == false)
+	{
+		cout << "Failed to write " << name << "." << endl;
+		return false;
+	}
+	file << setprecision(GENERATOR_PRECISION);
+	return true;
+}
+
+/**
+Sets a generation parameter by name.
+
+Requires the name of a public parameter attribute (as listed in the class declaration) and its new value. Integer parameters are rounded to the nearest integer.
+
+Returns true if the name was recognized, and false otherwise.
+*/
+bool InstanceGenerator::set_parameter(const string &name, double value)
+{
+	pair<string, int *> int_parameters[] = { {"hlines", &hlines}, {"vlines", &vlines}, {"minbetween", &minbetween}, {"maxbetween", &maxbetween},
+		{"facilities", &facilities}, {"populations", &populations}, {"minpop", &minpop}, {"maxpop", &maxpop}, {"wneighbors", &wneighbors},
+		{"odjiggle", &odjiggle}, {"odfloor", &odfloor}, {"bfleet", &bfleet}, {"bmax", &bmax}, {"linemin", &linemin}, {"linemax", &linemax},
+		{"cutoff", &cutoff}, {"step", &step}, {"direction", &direction} };
+	pair<string, double *> double_parameters[] = { {"hgap", &hgap}, {"vgap", &vgap}, {"jiggle", &jiggle}, {"horizon", &horizon},
+		{"wspeed", &wspeed}, {"minbspeed", &minbspeed}, {"maxbspeed", &maxbspeed}, {"minbstop", &minbstop}, {"maxbstop", &maxbstop},
+		{"minbturnaround", &minbturnaround}, {"maxbturnaround", &maxbturnaround}, {"wradius", &wradius}, {"wradius2", &wradius2},
+		{"popspace", &popspace}, {"tripmean", &tripmean}, {"tripsd", &tripsd}, {"popfrac", &popfrac}, {"bseats", &bseats}, {"fare", &fare},
+		{"riding_weight", &riding_weight}, {"walking_weight", &walking_weight}, {"waiting_weight", &waiting_weight}, {"epsilon", &epsilon},
+		{"flow_tolerance", &flow_tolerance}, {"waiting_tolerance", &waiting_tolerance}, {"alpha", &alpha} };
+
+	for (int i = 0; i < sizeof(int_parameters) / sizeof(int_parameters[0]); i++)
+	{
+		if (int_parameters[i].first == name)
+		{
+			*int_parameters[i].second = lround(value);
+			return true;
+		}
+	}
+	for (int i = 0; i < sizeof(double_parameters) / sizeof(double_parameters[0]); i++)
+	{
+		if (double_parameters[i].first == name)
+		{
+			*double_parameters[i].second = value;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+Generates an instance and writes its data files.
+
+Requires the instance folder, which is given the data and log subfolders expected by the user cost search (created if necessary).
+
+Returns true if every data file was written successfully.
+
+The network is written as soon as it is complete, and the travel demands are written as they are generated, so that only the network and a single block of demands are ever held in memory.
+*/
+bool InstanceGenerator::generate(const string &folder)
+{
+	error_code error;
+	filesystem::create_directories(folder + "data", error);
+	filesystem::create_directories(folder + "log", error);
+	generator.seed(seed);
+
+	// Build network
+	build_stops();
+	build_lines();
+	build_walking();
+	build_centers();
+	cout << "Lines: " << line_stops.size() << endl;
+	cout << "Stops: " << stop_count << endl;
+	cout << "Nodes: " << node_type.size() << endl;
+	cout << "Arcs: " << arc_type.size() << endl;
+	if (write_network(folder) == false)
+		return false;
+
+	// Generate travel demands
+	ofstream od_file;
+	if (open_output(od_file, folder + OD_FILE) == false)
+		return false;
+	long long pairs = generate_demand(od_file);
+	od_file.close();
+	if (od_file.fail() == true)
+	{
+		cout << "Failed to write " << folder + OD_FILE << "." << endl;
+		return false;
+	}
+	cout << "Nonzero OD pairs: " << pairs << endl;
+
+	// Set fleet sizes and write the remaining files
+	assign_fleet();
+	cout << "Maximum fleet: " << *max_element(line_fleet.begin(), line_fleet.end()) << endl;
+	cout << "Minimum fleet: " << *min_element(line_fleet.begin(), line_fleet.end()) << endl;
+
+	return write_lines(folder) && write_parameters(folder);
+}
+
+/// Adds a node with given coordinates, type ID, line ID, stop ID, and value, and returns its ID.
+int InstanceGenerator::add_node(double x, double y, int type, int line, int stop, double value)
+{
+	node_x.push_back(x);
+	node_y.push_back(y);
+	node_type.push_back(type);
+	node_line.push_back(line);
+	node_stop.push_back(stop);
+	node_value.push_back(value);
+	return node_type.size() - 1;
+}
+
+/// Adds an arc with given type ID, line ID, tail and head node IDs, and travel time, and returns its ID.
+int InstanceGenerator::add_arc(int type, int line, int tail, int head, double time)
+{
+	arc_type.push_back(type);
+	arc_line.push_back(line);
+	arc_tail.push_back(tail);
+	arc_head.push_back(head);
+	arc_time.push_back(time);
+	return arc_type.size() - 1;
+}
+
+/**
+Places all stops.
+
+A stop is placed at every grid intersection, with the intersections numbered row by row from the bottom left, and each is randomly displaced. A random number of stops is then inserted between each pair of consecutive intersections along each column (with their own random displacements) and then along each row. The stops along each line are recorded in order, with the columns first.
+*/
+void InstanceGenerator::build_stops()
+{
+	uniform_real_distribution<double> jiggle_distribution(-jiggle, jiggle);
+	uniform_int_distribution<int> between_distribution(minbetween, maxbetween);
+
+	// Grid intersections
+	for (int i = 0; i < hlines; i++)
+	{
+		for (int j = 0; j < vlines; j++)
+		{
+			double x = vgap * j + jiggle_distribution(generator);
+			double y = hgap * i + jiggle_distribution(generator);
+			add_node(x, y, STOP_NODE, NO_ID, NO_ID, -1);
+		}
+	}
+
+	// Stops between intersections along each column, from bottom to top
+	for (int i = 0; i < vlines; i++)
+	{
+		vector<int> column;
+		for (int j = 0; j < hlines - 1; j++)
+		{
+			column.push_back(i + vlines * j);
+			int between = between_distribution(generator);
+			double increment = hgap / (between + 1);
+			for (int k = 0; k < between; k++)
+			{
+				int last = column.back();
+				double x = node_x[last] + jiggle_distribution(generator);
+				double y = node_y[last] + increment + jiggle_distribution(generator);
+				column.push_back(add_node(x, y, STOP_NODE, NO_ID, NO_ID, -1));
+			}
+		}
+		column.push_back(i + vlines * (hlines - 1));
+		line_stops.push_back(column);
+	}
+
+	// Stops between intersections along each row, from left to right
+	for (int i = 0; i < hlines; i++)
+	{
+		vector<int> row;
+		for (int j = 0; j < vlines - 1; j++)
+		{
+			row.push_back(vlines * i + j);
+			int between = between_distribution(generator);
+			double increment = vgap / (between + 1);
+			for (int k = 0; k < between; k++)
+			{
+				int last = row.back();
+				row.push_back(add_node(node_x[last] + increment, node_y[last], STOP_NODE, NO_ID, NO_ID, -1));
+			}
+		}
+		row.push_back(vlines * i + vlines - 1);
+		line_stops.push_back(row);
+	}
+
+	stop_count = node_type.size();
+}
+
+/**
+Adds the boarding nodes and arcs of every line.
+
+Every line first receives a boarding node at each of its stops, connected to the stop by a boarding arc and an alighting arc. Line arcs are then added in both directions between each pair of consecutive boarding nodes, with a random stop time plus a travel time based on a random bus speed. A line's circuit time consists of all of its line arcs' times plus a random turnaround time at each end.
+*/
+void InstanceGenerator::build_lines()
+{
+	uniform_real_distribution<double> stop_distribution(minbstop, maxbstop);
+	uniform_real_distribution<double> speed_distribution(minbspeed, maxbspeed);
+	uniform_real_distribution<double> turnaround_distribution(minbturnaround, maxbturnaround);
+	vector<vector<int>> line_boarding(line_stops.size()); // boarding node IDs along each line, in order
+
+	// Boarding nodes with boarding and alighting arcs
+	for (int i = 0; i < line_stops.size(); i++)
+	{
+		for (int j = 0; j < line_stops[i].size(); j++)
+		{
+			int stop = line_stops[i][j];
+			int boarding = add_node(node_x[stop], node_y[stop], BOARDING_NODE, i, stop, -1);
+			add_arc(BOARDING_ARC, i, stop, boarding, 0.0);
+			add_arc(ALIGHTING_ARC, NO_ID, boarding, stop, 0.0);
+			line_boarding[i].push_back(boarding);
+		}
+	}
+
+	// Line arcs in both directions between consecutive boarding nodes
+	line_arcs.resize(line_stops.size());
+	line_circuit.assign(line_stops.size(), 0.0);
+	for (int i = 0; i < line_boarding.size(); i++)
+	{
+		for (int j = 0; j + 1 < line_boarding[i].size(); j++)
+		{
+			int tail = line_boarding[i][j];
+			int head = line_boarding[i][j + 1];
+			double distance = hypot(node_x[head] - node_x[tail], node_y[head] - node_y[tail]);
+			double time = stop_distribution(generator) + distance / speed_distribution(generator);
+			line_arcs[i].push_back(add_arc(LINE_ARC, i, tail, head, time));
+			line_circuit[i] += time;
+			time = stop_distribution(generator) + distance / speed_distribution(generator);
+			line_arcs[i].push_back(add_arc(LINE_ARC, i, head, tail, time));
+			line_circuit[i] += time;
+		}
+		line_circuit[i] += turnaround_distribution(generator);
+		line_circuit[i] += turnaround_distribution(generator);
+	}
+}
+
+/**
+Adds core walking arcs between every pair of stops within the walking radius (measured as taxicab distance).
+
+Stops are sorted into square buckets as wide as the walking radius, so that each stop only needs to be compared with the stops in its own and neighboring buckets. The nearby stops of each stop are found in parallel, and the arcs are then added in the same order as a comparison of every pair of stops would add them.
+*/
+void InstanceGenerator::build_walking()
+{
+	if ((wradius <= 0) || (stop_count == 0))
+		return;
+
+	// Sort stops into buckets
+	double x_min = *min_element(node_x.begin(), node_x.begin() + stop_count);
+	double y_min = *min_element(node_y.begin(), node_y.begin() + stop_count);
+	double x_max = *max_element(node_x.begin(), node_x.begin() + stop_count);
+	double y_max = *max_element(node_y.begin(), node_y.begin() + stop_count);
+	int columns = (x_max - x_min) / wradius + 1; // number of bucket columns
+	int rows = (y_max - y_min) / wradius + 1; // number of bucket rows
+	vector<int> stop_bucket(stop_count); // bucket of each stop
+	vector<int> bucket_start(columns * rows + 1, 0); // position of each bucket's first stop in the bucket list, followed by the list's total size
+	for (int i = 0; i < stop_count; i++)
+	{
+		int column = min(columns - 1, (int) ((node_x[i] - x_min) / wradius));
+		int row = min(rows - 1, (int) ((node_y[i] - y_min) / wradius));
+		stop_bucket[i] = row * columns + column;
+		bucket_start[stop_bucket[i] + 1]++;
+	}
+	for (int b = 0; b < columns * rows; b++)
+		bucket_start[b + 1] += bucket_start[b];
+	vector<int> bucket_stops(stop_count); // stop IDs grouped by bucket, in ascending order within each bucket
+	vector<int> next(bucket_start.begin(), bucket_start.end() - 1);
+	for (int i = 0; i < stop_count; i++)
+		bucket_stops[next[stop_bucket[i]]++] = i;
+
+	// Find the nearby lower-numbered stops of each stop
+	vector<vector<int>> nearby(stop_count);
+	Pool->run(stop_count, [&](int i, int worker)
+	{
+		int column = stop_bucket[i] % columns;
+		int row = stop_bucket[i] / columns;
+		for (int r = max(0, row - 1); r <= min(rows - 1, row + 1); r++)
+		{
+			for (int c = max(0, column - 1); c <= min(columns - 1, column + 1); c++)
+			{
+				int b = r * columns + c;
+				for (int k = bucket_start[b]; (k < bucket_start[b + 1]) && (bucket_stops[k] < i); k++)
+				{
+					int j = bucket_stops[k];
+					if (fabs(node_x[i] - node_x[j]) + fabs(node_y[i] - node_y[j]) <= wradius)
+						nearby[i].push_back(j);
+				}
+			}
+		}
+		sort(nearby[i].begin(), nearby[i].end());
+	});
+
+	// Add arcs in both directions
+	for (int i = 0; i < stop_count; i++)
+	{
+		for (int k = 0; k < nearby[i].size(); k++)
+		{
+			int j = nearby[i][k];
+			double time = (fabs(node_x[i] - node_x[j]) + fabs(node_y[i] - node_y[j])) / wspeed;
+			add_arc(WALKING_ARC, NO_ID, i, j, time);
+			add_arc(WALKING_ARC, NO_ID, j, i, time);
+		}
+	}
+}
+
+/**
+Places population centers and facilities and adds their access walking arcs.
+
+Population centers are placed uniformly at random within the grid, rejecting any candidate which is too close to an existing center until too many candidates have been rejected, and receive a random population. Facilities are placed uniformly at random and all have a weight of 1.
+
+Each population center is then connected by walking arcs in both directions to its nearest few stops, population centers, and facilities within the access walking radius, and each facility likewise to its nearest few stops and facilities. Neighbors are found in parallel.
+*/
+void InstanceGenerator::build_centers()
+{
+	double width = (vlines - 1) * vgap; // horizontal extent of the grid
+	double height = (hlines - 1) * hgap; // vertical extent of the grid
+	uniform_real_distribution<double> x_distribution(0.0, width);
+	uniform_real_distribution<double> y_distribution(0.0, height);
+
+	// Population center locations
+	vector<double> population_x, population_y;
+	int fails = 0; // number of rejected candidates
+	while (population_x.size() < populations)
+	{
+		double x = x_distribution(generator);
+		double y = y_distribution(generator);
+		bool accept = true;
+		if (fails <= 500)
+		{
+			for (int i = 0; i < population_x.size(); i++)
+			{
+				if (hypot(x - population_x[i], y - population_y[i]) < popspace)
+				{
+					accept = false;
+					fails++;
+					break;
+				}
+			}
+		}
+		if (accept == true)
+		{
+			population_x.push_back(x);
+			population_y.push_back(y);
+		}
+	}
+
+	// Population center nodes
+	uniform_int_distribution<int> population_distribution(minpop, maxpop);
+	int first_population = node_type.size(); // node ID of the first population center
+	for (int i = 0; i < populations; i++)
+		add_node(population_x[i], population_y[i], POPULATION_NODE, NO_ID, NO_ID, population_distribution(generator));
+
+	// Facility nodes, with all horizontal coordinates chosen before the vertical coordinates
+	vector<double> facility_x(facilities);
+	for (int i = 0; i < facilities; i++)
+		facility_x[i] = x_distribution(generator);
+	for (int i = 0; i < facilities; i++)
+		add_node(facility_x[i], y_distribution(generator), FACILITY_NODE, NO_ID, NO_ID, 1);
+
+	// Find the nearest neighbors of each population center and facility
+	int center_count = populations + facilities;
+	vector<vector<int>> neighbors(center_count);
+	Pool->run(center_count, [&](int task, int worker)
+	{
+		int center = first_population + task;
+		vector<pair<double, int>> candidates; // distance/node ID pairs of all neighbors within the radius
+		for (int i = 0; i < node_type.size(); i++)
+		{
+			if ((i == center) || (node_type[i] == BOARDING_NODE))
+				continue;
+			if ((node_type[center] == FACILITY_NODE) && (node_type[i] == POPULATION_NODE))
+				// Facilities only connect to stops and other facilities
+				continue;
+			double distance = hypot(node_x[i] - node_x[center], node_y[i] - node_y[center]);
+			if (distance <= wradius2)
+				candidates.push_back(make_pair(distance, i));
+		}
+		int count = min((int) candidates.size(), wneighbors);
+		partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+		for (int i = 0; i < count; i++)
+			neighbors[task].push_back(candidates[i].second);
+	});
+
+	// Add arcs in both directions
+	for (int i = 0; i < center_count; i++)
+	{
+		int center = first_population + i;
+		if (neighbors[i].empty() == true)
+			cout << "Stranded node " << center << "." << endl;
+		for (int j = 0; j < neighbors[i].size(); j++)
+		{
+			int neighbor = neighbors[i][j];
+			double time = (fabs(node_x[center] - node_x[neighbor]) + fabs(node_y[center] - node_y[neighbor])) / wspeed;
+			add_arc(ACCESS_ARC, NO_ID, center, neighbor, time);
+			add_arc(ACCESS_ARC, NO_ID, neighbor, center, time);
+		}
+	}
+}
+
+/**
+Generates the travel demands between all stops.
+
+Requires the O/D data file, which should already be open.
+
+Returns the number of nonzero O/D pairs written.
+
+Each stop is assigned to its nearest population center, and each center's transit-using population is divided evenly among its stops to become their total outgoing demand. Each stop's demand is split between all other stops in proportion to the gamma distribution of trip lengths, evaluated at the estimated bus travel time between them, and then rounded and perturbed with random noise, with any demand below the threshold being dropped.
+
+The fleet sizes are based on the demand that each arc would carry if all travel followed its shortest path, so a shortest path tree is also grown from each origin until reaching all of its destinations, and each O/D pair's demand is added to the volume of every arc along its path.
+
+Origins are processed in blocks, with the origins of each block being processed in parallel. The demands of each block are then written in order of origin and destination before moving on to the next block. Each worker keeps its own arc volumes, which are summed at the end. Since all volumes are integers this sum is exact, so the result does not depend on the number of workers.
+*/
+long long InstanceGenerator::generate_demand(ofstream &od_file)
+{
+	int node_count = node_type.size();
+	int arc_count = arc_type.size();
+
+	// Divide each population center's population among its nearest stops
+	stop_volume.assign(stop_count, 0);
+	int first_population = stop_count;
+	while ((first_population < node_count) && (node_type[first_population] != POPULATION_NODE))
+		first_population++;
+	if (populations > 0)
+	{
+		vector<int> nearest(stop_count); // nearest population center of each stop
+		vector<int> center_stops(populations, 0); // number of stops assigned to each population center
+		for (int i = 0; i < stop_count; i++)
+		{
+			double best = INFINITY;
+			for (int p = 0; p < populations; p++)
+			{
+				double distance = hypot(node_x[i] - node_x[first_population + p], node_y[i] - node_y[first_population + p]);
+				if (distance < best)
+				{
+					best = distance;
+					nearest[i] = p;
+				}
+			}
+			center_stops[nearest[i]]++;
+		}
+		for (int i = 0; i < stop_count; i++)
+			stop_volume[i] = floor(popfrac * node_value[first_population + nearest[i]] / center_stops[nearest[i]]);
+	}
+
+	// Build outgoing arc lists of all nodes for the shortest path search
+	vector<int> out_start(node_count + 1, 0);
+	for (int a = 0; a < arc_count; a++)
+		out_start[arc_tail[a] + 1]++;
+	for (int i = 0; i < node_count; i++)
+		out_start[i + 1] += out_start[i];
+	vector<int> out_arcs(arc_count);
+	vector<int> next(out_start.begin(), out_start.end() - 1);
+	for (int a = 0; a < arc_count; a++)
+		out_arcs[next[arc_tail[a]]++] = a;
+
+	// Scratch space for each worker
+	int workers = Pool->worker_count;
+	vector<vector<double>> weights(workers, vector<double>(stop_count)); // trip length weights from the current origin
+	vector<vector<double>> distances(workers, vector<double>(node_count, INFINITY)); // tentative distances from the current origin
+	vector<vector<int>> predecessors(workers, vector<int>(node_count, NO_ID)); // last arc of the shortest path to each node
+	vector<vector<int>> touched(workers); // nodes whose distances must be reset
+	vector<vector<double>> volumes(workers, vector<double>(arc_count, 0.0)); // arc volumes tallied by each worker
+
+	double mean_speed = (minbspeed + maxbspeed) / 2;
+	long long pairs = 0;
+	od_file << "ID\tOrigin\tDestination\tVolume\n";
+	for (int block = 0; block < stop_count; block += GENERATOR_BLOCK)
+	{
+		int block_size = min(GENERATOR_BLOCK, stop_count - block);
+		vector<vector<pair<int, int>>> demands(block_size); // destination/volume pairs of each origin in the block
+
+		Pool->run(block_size, [&](int task, int worker)
+		{
+			int origin = block + task;
+			if (stop_volume[origin] <= 0)
+				return;
+
+			// Weigh every destination by estimated travel time
+			vector<double> &weight = weights[worker];
+			double total = 0.0;
+			for (int j = 0; j < stop_count; j++)
+			{
+				weight[j] = trip_weight((fabs(node_x[origin] - node_x[j]) + fabs(node_y[origin] - node_y[j])) / mean_speed);
+				total += weight[j];
+			}
+			if (total <= 0)
+				return;
+
+			// Split the origin's volume, add noise, and drop small demands
+			seed_seq origin_seed = { seed, (unsigned int) origin };
+			mt19937_64 origin_generator(origin_seed);
+			uniform_int_distribution<int> noise_distribution(-odjiggle, odjiggle);
+			for (int j = 0; j < stop_count; j++)
+			{
+				int volume = nearbyint(stop_volume[origin] * weight[j] / total);
+				if (volume >= odfloor)
+					volume += noise_distribution(origin_generator);
+				if ((volume < odfloor) || (j == origin))
+					continue;
+				demands[task].push_back(make_pair(j, volume));
+			}
+			if (demands[task].empty() == true)
+				return;
+
+			// Grow a shortest path tree until every destination has been reached
+			vector<double> &distance = distances[worker];
+			vector<int> &predecessor = predecessors[worker];
+			vector<bool> destination(stop_count, false);
+			for (int k = 0; k < demands[task].size(); k++)
+				destination[demands[task][k].first] = true;
+			int remaining = demands[task].size();
+			priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> node_queue;
+			distance[origin] = 0.0;
+			touched[worker].push_back(origin);
+			node_queue.push(make_pair(0.0, origin));
+			while ((remaining > 0) && (node_queue.empty() == false))
+			{
+				pair<double, int> chosen = node_queue.top();
+				node_queue.pop();
+				int i = chosen.second;
+				if (chosen.first > distance[i])
+					// Skip outdated copies
+					continue;
+				if ((i < stop_count) && (destination[i] == true))
+				{
+					destination[i] = false;
+					remaining--;
+				}
+				for (int k = out_start[i]; k < out_start[i + 1]; k++)
+				{
+					int a = out_arcs[k];
+					double label = distance[i] + arc_time[a];
+					if (label < distance[arc_head[a]])
+					{
+						if (distance[arc_head[a]] == INFINITY)
+							touched[worker].push_back(arc_head[a]);
+						distance[arc_head[a]] = label;
+						predecessor[arc_head[a]] = a;
+						node_queue.push(make_pair(label, arc_head[a]));
+					}
+				}
+			}
+
+			// Add each demand to the arcs along its path
+			for (int k = 0; k < demands[task].size(); k++)
+			{
+				int j = demands[task][k].first;
+				if (distance[j] == INFINITY)
+					continue;
+				for (int i = j; i != origin; i = arc_tail[predecessor[i]])
+					volumes[worker][predecessor[i]] += demands[task][k].second;
+			}
+
+			// Reset tree
+			for (int k = 0; k < touched[worker].size(); k++)
+			{
+				distance[touched[worker][k]] = INFINITY;
+				predecessor[touched[worker][k]] = NO_ID;
+			}
+			touched[worker].clear();
+		});
+
+		// Write the block's demands
+		for (int task = 0; task < block_size; task++)
+			for (int k = 0; k < demands[task].size(); k++)
+				od_file << pairs++ << '\t' << block + task << '\t' << demands[task][k].first << '\t' << demands[task][k].second << '\n';
+	}
+
+	// Sum arc volumes
+	arc_volume.assign(arc_count, 0.0);
+	for (int w = 0; w < workers; w++)
+		for (int a = 0; a < arc_count; a++)
+			arc_volume[a] += volumes[w][a];
+
+	return pairs;
+}
+
+/**
+Sets the initial fleet size of each line.
+
+The total fleet is divided among the lines in proportion to the largest volume on any of their line arcs, and rounding errors are then corrected by adding or removing single vehicles from random lines until the total is correct. The fleet is divided evenly if no line carries any volume.
+*/
+void InstanceGenerator::assign_fleet()
+{
+	vector<double> line_volume(line_arcs.size(), 0.0);
+	double total = 0.0;
+	for (int i = 0; i < line_arcs.size(); i++)
+	{
+		for (int j = 0; j < line_arcs[i].size(); j++)
+			line_volume[i] = max(line_volume[i], arc_volume[line_arcs[i][j]]);
+		total += line_volume[i];
+	}
+
+	line_fleet.assign(line_arcs.size(), 0);
+	int fleet_total = 0;
+	for (int i = 0; i < line_arcs.size(); i++)
+	{
+		if (total > 0)
+			line_fleet[i] = nearbyint(bfleet * line_volume[i] / total);
+		else
+			line_fleet[i] = nearbyint((double) bfleet / line_arcs.size());
+		fleet_total += line_fleet[i];
+	}
+
+	// Correct rounding errors
+	uniform_int_distribution<int> line_distribution(0, line_arcs.size() - 1);
+	while (fleet_total != bfleet)
+	{
+		int i = line_distribution(generator);
+		if (fleet_total > bfleet)
+		{
+			if (line_fleet[i] > 0)
+			{
+				line_fleet[i]--;
+				fleet_total--;
+			}
+		}
+		else
+		{
+			line_fleet[i]++;
+			fleet_total++;
+		}
+	}
+}
+
+/// Evaluates the gamma distribution of trip lengths (up to a constant factor) at a given estimated travel time.
+double InstanceGenerator::trip_weight(double time)
+{
+	double shape = (tripmean * tripmean - tripsd * tripsd) / (tripsd * tripsd); // exponent of the travel time
+	double rate = tripmean / (tripsd * tripsd); // rate of exponential decay
+	if (time <= 0)
+		return (shape > 0) ? 0.0 : 1.0;
+	return exp(shape * log(time) - rate * time);
+}
+
+/**
+Writes the network data files.
+
+Requires the instance folder.
+
+Returns true if the node, arc, and node coordinate data files were all written successfully.
+*/
+bool InstanceGenerator::write_network(const string &folder)
+{
+	// Node data and node coordinates
+	ofstream node_file, coordinate_file;
+	if ((open_output(node_file, folder + NODE_FILE) == false) || (open_output(coordinate_file, folder + COORDINATE_FILE) == false))
+		return false;
+	node_file << "ID\tName\tType\tLine\tValue\n";
+	coordinate_file << "ID\tx\ty\n";
+	int population_count = 0; // number of population centers written so far
+	int facility_count = 0; // number of facilities written so far
+	for (int i = 0; i < node_type.size(); i++)
+	{
+		node_file << i << '\t';
+		switch (node_type[i])
+		{
+			case STOP_NODE:
+				node_file << "Stop" << i;
+				break;
+			case BOARDING_NODE:
+				node_file << "Stop" << node_stop[i] << "_Route" << node_line[i];
+				break;
+			case POPULATION_NODE:
+				node_file << "Pop" << population_count++;
+				break;
+			case FACILITY_NODE:
+				node_file << "Fac" << facility_count++;
+				break;
+		}
+		node_file << '\t' << node_type[i] << '\t' << node_line[i] << '\t' << node_value[i] << '\n';
+		coordinate_file << i << '\t' << node_x[i] << '\t' << node_y[i] << '\n';
+	}
+	node_file.close();
+	coordinate_file.close();
+
+	// Arc data
+	ofstream arc_file;
+	if (open_output(arc_file, folder + ARC_FILE) == false)
+		return false;
+	arc_file << "ID\tType\tLine\tTail\tHead\tTime\n";
+	for (int i = 0; i < arc_type.size(); i++)
+		arc_file << i << '\t' << arc_type[i] << '\t' << arc_line[i] << '\t' << arc_tail[i] << '\t' << arc_head[i] << '\t' << arc_time[i] << '\n';
+	arc_file.close();
+
+	if ((node_file.fail() == true) || (coordinate_file.fail() == true) || (arc_file.fail() == true))
+	{
+		cout << "Failed to write network data." << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+Writes the line data files.
+
+Requires the instance folder.
+
+Returns true if the transit and vehicle data files were both written successfully.
+*/
+bool InstanceGenerator::write_lines(const string &folder)
+{
+	ofstream transit_file, vehicle_file;
+	if ((open_output(transit_file, folder + TRANSIT_FILE) == false) || (open_output(vehicle_file, folder + VEHICLE_FILE) == false))
+		return false;
+
+	transit_file << "ID\tName\tType\tFleet\tCircuit\tScaling\tLB\tUB\tFare\tFrequency\tCapacity\n";
+	for (int i = 0; i < line_fleet.size(); i++)
+	{
+		double frequency = line_fleet[i] / line_circuit[i];
+		transit_file << i << "\tRoute" << i << "\t0\t" << line_fleet[i] << '\t' << line_circuit[i] << "\t1.0\t" << linemin << '\t' << linemax << '\t' << fare << '\t';
+		transit_file << frequency << '\t' << frequency * horizon * bseats << '\n';
+	}
+	transit_file.close();
+
+	vehicle_file << "Type\tName\tUB\tCapacity\tCost\n";
+	vehicle_file << "0\tBus1\t" << bmax << '\t' << bseats << "\t-1\n";
+	vehicle_file.close();
+
+	if ((transit_file.fail() == true) || (vehicle_file.fail() == true))
+	{
+		cout << "Failed to write line data." << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+Writes the parameter data files.
+
+Requires the instance folder.
+
+Returns true if the problem, user cost, and assignment data files were all written successfully. The conical congestion function's beta parameter is calculated from alpha.
+*/
+bool InstanceGenerator::write_parameters(const string &folder)
+{
+	ofstream problem_file, user_cost_file, assignment_file;
+	if ((open_output(problem_file, folder + PROBLEM_FILE) == false) || (open_output(user_cost_file, folder + USER_COST_FILE) == false) || (open_output(assignment_file, folder + ASSIGNMENT_FILE) == false))
+		return false;
+
+	problem_file << "Label\tValue\n";
+	problem_file << "Elements\t1\n";
+	problem_file << "Horizon\t" << horizon << '\n';
+	problem_file.close();
+
+	user_cost_file << "Label\tValue\n";
+	user_cost_file << "Initial\t-1\n";
+	user_cost_file << "Percent\t0.01\n";
+	user_cost_file << "Elements\t3\n";
+	user_cost_file << "Riding\t" << riding_weight << '\n';
+	user_cost_file << "Walking\t" << walking_weight << '\n';
+	user_cost_file << "Waiting\t" << waiting_weight << '\n';
+	user_cost_file.close();
+
+	assignment_file << "Label\tValue\n";
+	assignment_file << "Epsilon\t" << epsilon << '\n';
+	assignment_file << "Flow_Tolerance\t" << flow_tolerance << '\n';
+	assignment_file << "Waiting_Tolerance\t" << waiting_tolerance << '\n';
+	assignment_file << "Cutoff\t" << cutoff << '\n';
+	assignment_file << "Elements\t2\n";
+	assignment_file << "Alpha\t" << alpha << '\n';
+	assignment_file << "Beta\t" << (2 * alpha - 1) / (2 * alpha - 2) << '\n';
+	assignment_file << "Step\t" << step << '\n';
+	assignment_file << "Direction\t" << direction << '\n';
+	assignment_file.close();
+
+	if ((problem_file.fail() == true) || (user_cost_file.fail() == true) || (assignment_file.fail() == true))
+	{
+		cout << "Failed to write parameter data." << endl;
+		return false;
+	}
+	return true;
+}
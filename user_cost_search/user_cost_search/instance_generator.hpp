@@ -0,0 +1,135 @@
+/**
+Procedural generator for example problem instances.
+
+A native version of the network generation procedure from the social-transit-ex.nb notebook. The network is a square grid of vertical and horizontal transit lines with stops at every grid intersection and intermittently between them, along with randomly placed population centers and primary care facilities. Travel demands are drawn from a gamma distribution of trip lengths, and the initial fleet sizes are proportional to the busiest arc of each line when all demand follows its shortest path.
+
+The result is written to the data files described in format.txt, so it can be used directly by the user cost search.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "thread_pool.hpp"
+
+#define COORDINATE_FILE "data/node_coordinates.txt" // node coordinate file, for use in drawing the network
+#define GENERATOR_BLOCK 1024 // number of origins whose travel demands are generated together before being written
+#define GENERATOR_PRECISION 10 // number of significant digits written for real-valued data
+
+using namespace std;
+
+// Structure declarations
+struct InstanceGenerator;
+
+/**
+Instance generator class.
+
+The public parameter attributes are initialized to the values used in the notebook, and can be changed by name with set_parameter() before calling generate(). Distances are in miles and times in minutes.
+
+All random choices are made from a single seeded generator, except for the noise added to the travel demands of each origin, which comes from a generator seeded by the seed and the origin. This allows the travel demands to be generated in parallel while the output depends only on the seed and the parameters, and not on the number of threads.
+
+Nodes are numbered in the same order as the notebook: grid intersection stops, the stops inserted along the columns and then the rows, boarding nodes for each line, population centers, and finally facilities. The columns are lines 0 through vlines-1 and the rows follow. Unlike the notebook, the turnaround time at each end of a line is only included in the line's circuit time, and not as a separate looping arc.
+*/
+struct InstanceGenerator
+{
+	// Public attributes (network parameters)
+	int hlines = 5; // number of grid lines running horizontally
+	int vlines = 7; // number of grid lines running vertically
+	double hgap = 0.2; // distance between horizontal lines
+	double vgap = 0.2; // distance between vertical lines
+	double jiggle = 0.002; // random displacement for each grid node
+	double horizon = 60; // total time horizon
+	int minbetween = 0; // minimum number of stops to place between grid intersections
+	int maxbetween = 2; // maximum number of stops to place between grid intersections
+	double wspeed = 0.0455; // pedestrian walking speed (miles per minute)
+	double minbspeed = 0.3; // minimum bus speed (miles per minute)
+	double maxbspeed = 0.5; // maximum bus speed (miles per minute)
+	double minbstop = 0.5; // minimum bus stop time
+	double maxbstop = 0.75; // maximum bus stop time
+	double minbturnaround = 5; // minimum bus turnaround time
+	double maxbturnaround = 30; // maximum bus turnaround time
+	double wradius = 0.12; // taxicab distance cutoff for core walking arcs
+	double wradius2 = 0.25; // distance cutoff for access walking arcs
+
+	// Public attributes (population and facility parameters)
+	int facilities = 8; // number of facilities
+	int populations = 16; // number of population centers
+	double popspace = 0.2; // minimum required spacing between population centers
+	int minpop = 1000; // minimum population of a population center
+	int maxpop = 2500; // maximum population of a population center
+	int wneighbors = 4; // maximum number of walking neighbors of each population center and facility
+
+	// Public attributes (demand and fleet parameters)
+	double tripmean = 2; // mean passenger trip length
+	double tripsd = 1.25; // passenger trip length standard deviation
+	double popfrac = 0.3; // fraction of population that uses public transit during the time horizon
+	int odjiggle = 2; // random noise for travel demands
+	int odfloor = 1; // travel demand threshold, below which the demand is ignored
+	double bseats = 39; // number of seats on each bus
+	int bfleet = 100; // number of vehicles present in the initial solution
+	int bmax = 100; // maximum number of vehicles allowed
+	int linemin = 1; // minimum number of vehicles per line
+	int linemax = 20; // maximum number of vehicles per line
+	double fare = 2.25; // boarding fare
+
+	// Public attributes (model parameters, written to the parameter data files)
+	double riding_weight = 1.0; // user cost weight for in-vehicle travel time
+	double walking_weight = 2.0; // user cost weight for walking time
+	double waiting_weight = 3.0; // user cost weight for waiting time
+	double epsilon = 0.01; // Frank-Wolfe optimality gap threshold
+	double flow_tolerance = 0.01; // Frank-Wolfe flow vector change threshold
+	double waiting_tolerance = 0.01; // Frank-Wolfe waiting time change threshold
+	int cutoff = 20; // Frank-Wolfe iteration cutoff
+	double alpha = 4.0; // alpha parameter of the conical congestion function
+	int step = STEP_MSA; // Frank-Wolfe step size rule
+	int direction = DIRECTION_FW; // Frank-Wolfe search direction rule
+
+	// Public attributes (generated network)
+	mt19937_64 generator; // main random number generator
+	unsigned int seed = 1; // random seed
+	int stop_count; // number of stop nodes
+	vector<double> node_x; // horizontal coordinate of each node
+	vector<double> node_y; // vertical coordinate of each node
+	vector<int> node_type; // type ID of each node
+	vector<int> node_line; // line ID of each boarding node (-1 otherwise)
+	vector<int> node_stop; // stop node ID of each boarding node (-1 otherwise)
+	vector<double> node_value; // population of each population center, weight of each facility, and -1 otherwise
+	vector<vector<int>> line_stops; // stop node IDs along each line, in order
+	vector<int> arc_type; // type ID of each arc
+	vector<int> arc_line; // line ID of each line and boarding arc (-1 otherwise)
+	vector<int> arc_tail; // tail node ID of each arc
+	vector<int> arc_head; // head node ID of each arc
+	vector<double> arc_time; // constant travel time of each arc
+	vector<vector<int>> line_arcs; // line arc IDs of each line
+	vector<double> line_circuit; // circuit time of each line
+	vector<int> line_fleet; // initial fleet size of each line
+	vector<int> stop_volume; // total outgoing travel demand of each stop
+	vector<double> arc_volume; // total travel demand whose shortest path uses each arc
+
+	// Public methods
+	bool set_parameter(const string &, double); // sets a parameter by name, returning whether the name was recognized
+	bool generate(const string &); // generates an instance and writes its data files to the given folder, returning whether all files were written
+	int add_node(double, double, int, int, int, double); // adds a node with given coordinates, type, line, stop, and value, returning its ID
+	int add_arc(int, int, int, int, double); // adds an arc with given type, line, tail, head, and time, returning its ID
+	void build_stops(); // places the grid intersection stops and the stops between them
+	void build_lines(); // adds boarding nodes along with boarding, alighting, and line arcs for every line
+	void build_walking(); // adds core walking arcs between nearby stops
+	void build_centers(); // places population centers and facilities and connects them to their nearest neighbors
+	long long generate_demand(ofstream &); // generates all travel demands, writing them to the O/D file and tallying arc volumes along their shortest paths, and returns the number of nonzero O/D pairs
+	void assign_fleet(); // sets initial fleet sizes in proportion to each line's busiest arc
+	double trip_weight(double); // evaluates the gamma distribution of trip lengths
+	bool write_network(const string &); // writes the node, arc, and coordinate data files, returning whether they were written
+	bool write_lines(const string &); // writes the transit and vehicle data files, returning whether they were written
+	bool write_parameters(const string &); // writes the problem, user cost, and assignment data files, returning whether they were written
+};
@@ -0,0 +1,233 @@
+/// Instrumentation class methods.
+
+#include "instrumentation.hpp"
+
+#if (INSTRUMENT == INSTRUMENT_HARDWARE) && defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Global profiler
+Profiler Profile;
+
+// Column names of the event counters, phase timers, and hardware counters, in ID order
+static const char * COUNTER_NAMES[COUNTERS] = { "candidates", "log_hits", "evaluations", "fw_iterations", "fw_error_stops", "fw_change_stops", "fw_cutoff_stops",
+	"constant_solves", "destinations", "heap_pushes", "heap_pops", "stale_pops", "attractive_arcs" };
+static const char * TIMER_NAMES[TIMERS] = { "constant_seconds", "label_seconds", "load_seconds", "reduction_seconds", "update_seconds", "line_search_seconds", "lock_wait_seconds" };
+static const char * HARDWARE_NAMES[HARDWARE_COUNTERS] = { "instructions", "cycles", "cache_references", "cache_misses" };
+
+/// Profiler destructor closes any hardware counters.
+Profiler::~Profiler()
+{
+	close_hardware();
+}
+
+/**
+Clears all counters and timers and opens the output files.
+
+Requires the number of workers in the thread pool.
+
+Any hardware counters from an earlier start are closed, since they belong to the workers of an earlier pool. The output files are overwritten.
+*/
+void Profiler::start(int workers)
+{
+	close_hardware();
+	blocks = vector<ProfileBlock>(workers);
+	last_counts.assign(COUNTERS, 0);
+	last_nanoseconds.assign(TIMERS, 0);
+	last_hardware.assign(HARDWARE_COUNTERS, 0);
+	last_time = chrono::steady_clock::now();
+
+	// Reopen the output files and write the CSV header
+	if (csv_file.is_open() == true)
+		csv_file.close();
+	if (json_file.is_open() == true)
+		json_file.close();
+	csv_file.open(FILE_BASE + PROFILE_CSV_FILE);
+	json_file.open(FILE_BASE + PROFILE_JSON_FILE);
+	csv_file << "iteration,wall_seconds";
+	for (int i = 0; i < COUNTERS; i++)
+		csv_file << ',' << COUNTER_NAMES[i];
+	for (int i = 0; i < TIMERS; i++)
+		csv_file << ',' << TIMER_NAMES[i];
+	if (INSTRUMENT == INSTRUMENT_HARDWARE)
+		for (int i = 0; i < HARDWARE_COUNTERS; i++)
+			csv_file << ',' << HARDWARE_NAMES[i];
+	csv_file << endl;
+}
+
+/// Returns the calling worker's block, opening its hardware counters the first time if they are in use.
+ProfileBlock &Profiler::local()
+{
+	ProfileBlock &block = blocks[ThreadPool::worker()];
+	if ((INSTRUMENT == INSTRUMENT_HARDWARE) && (block.hardware_opened == false))
+		open_hardware(block);
+	return block;
+}
+
+/// Adds to an event counter of the calling worker.
+void Profiler::count(int counter, long long amount)
+{
+	local().counts[counter] += amount;
+}
+
+/// Adds a number of nanoseconds to a phase timer of the calling worker.
+void Profiler::add_time(int timer, long long nanoseconds)
+{
+	blocks[ThreadPool::worker()].nanoseconds[timer] += nanoseconds;
+}
+
+/**
+Opens the hardware counters of the calling worker.
+
+Requires the calling worker's block.
+
+Each counter follows only the thread which opens it, so every worker opens its own counters the first time that it counts an event. Only user space events are counted, which most systems allow without special permissions. If any counter cannot be opened a message is printed once, and that counter is left out of the totals.
+*/
+void Profiler::open_hardware(ProfileBlock &block)
+{
+	block.hardware_opened = true;
+#if (INSTRUMENT == INSTRUMENT_HARDWARE) && defined(__linux__)
+	unsigned long long configs[HARDWARE_COUNTERS] = { PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES };
+	for (int i = 0; i < HARDWARE_COUNTERS; i++)
+	{
+		perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(attributes));
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.size = sizeof(attributes);
+		attributes.config = configs[i];
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		block.hardware[i] = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+		if ((block.hardware[i] < 0) && (hardware_failed == false))
+		{
+			hardware_failed = true;
+			cerr << "Hardware counter " << HARDWARE_NAMES[i] << " is unavailable." << endl;
+		}
+	}
+#else
+	if (hardware_failed == false)
+	{
+		hardware_failed = true;
+		cerr << "Hardware counters are only available on Linux." << endl;
+	}
+#endif
+}
+
+/// Closes the hardware counters of all workers.
+void Profiler::close_hardware()
+{
+#if (INSTRUMENT == INSTRUMENT_HARDWARE) && defined(__linux__)
+	for (int w = 0; w < blocks.size(); w++)
+	{
+		for (int i = 0; i < HARDWARE_COUNTERS; i++)
+		{
+			if (blocks[w].hardware[i] >= 0)
+				close(blocks[w].hardware[i]);
+			blocks[w].hardware[i] = -1;
+		}
+	}
+#endif
+}
+
+/**
+Writes the record of a single search iteration.
+
+Requires the iteration number.
+
+The record contains the wall time since the last record (or since the start) along with the change in every counter and timer, summed over all workers. It is appended to both the CSV file and the JSON lines file, one line each.
+
+Must not be called while any task is running, since the workers' blocks are read without locking.
+*/
+void Profiler::record(int iteration)
+{
+	// Sum all workers' blocks
+	vector<long long> counts(COUNTERS, 0);
+	vector<long long> nanoseconds(TIMERS, 0);
+	vector<long long> hardware(HARDWARE_COUNTERS, 0);
+	for (int w = 0; w < blocks.size(); w++)
+	{
+		for (int i = 0; i < COUNTERS; i++)
+			counts[i] += blocks[w].counts[i];
+		for (int i = 0; i < TIMERS; i++)
+			nanoseconds[i] += blocks[w].nanoseconds[i];
+#if (INSTRUMENT == INSTRUMENT_HARDWARE) && defined(__linux__)
+		for (int i = 0; i < HARDWARE_COUNTERS; i++)
+		{
+			long long value;
+			if ((blocks[w].hardware[i] >= 0) && (read(blocks[w].hardware[i], &value, sizeof(value)) == sizeof(value)))
+				hardware[i] += value;
+		}
+#endif
+	}
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	double wall = chrono::duration<double>(now - last_time).count();
+
+	// Write the changes since the last record
+	csv_file << iteration << ',' << wall;
+	json_file << "{\"iteration\":" << iteration << ",\"wall_seconds\":" << wall;
+	for (int i = 0; i < COUNTERS; i++)
+	{
+		csv_file << ',' << counts[i] - last_counts[i];
+		json_file << ",\"" << COUNTER_NAMES[i] << "\":" << counts[i] - last_counts[i];
+	}
+	for (int i = 0; i < TIMERS; i++)
+	{
+		csv_file << ',' << (nanoseconds[i] - last_nanoseconds[i]) / 1.0e9;
+		json_file << ",\"" << TIMER_NAMES[i] << "\":" << (nanoseconds[i] - last_nanoseconds[i]) / 1.0e9;
+	}
+	if (INSTRUMENT == INSTRUMENT_HARDWARE)
+	{
+		for (int i = 0; i < HARDWARE_COUNTERS; i++)
+		{
+			csv_file << ',' << hardware[i] - last_hardware[i];
+			json_file << ",\"" << HARDWARE_NAMES[i] << "\":" << hardware[i] - last_hardware[i];
+		}
+	}
+	csv_file << endl;
+	json_file << '}' << endl;
+
+	last_counts = counts;
+	last_nanoseconds = nanoseconds;
+	last_hardware = hardware;
+	last_time = now;
+}
+
+/// Phase timer constructor starts timing a given phase.
+ProfileTimer::ProfileTimer(int timer_in)
+{
+	timer = timer_in;
+	start = chrono::steady_clock::now();
+}
+
+/// Phase timer destructor adds the elapsed time to its phase timer, unless it has already been stopped.
+ProfileTimer::~ProfileTimer()
+{
+	stop();
+}
+
+/// Adds the time elapsed since the timer started to its phase timer, after which the timer no longer counts.
+void ProfileTimer::stop()
+{
+	if (timer == NO_ID)
+		return;
+	Profile.add_time(timer, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+	timer = NO_ID;
+}
+
+/// Profiled lock guard constructor acquires a lock, timing the wait only if the lock is already held.
+ProfiledGuard::ProfiledGuard(mutex &lock_in) : lock(lock_in)
+{
+	if (lock.try_lock() == true)
+		return;
+	ProfileTimer wait(TIME_LOCK_WAIT);
+	lock.lock();
+}
+
+/// Profiled lock guard destructor releases its lock.
+ProfiledGuard::~ProfiledGuard()
+{
+	lock.unlock();
+}
@@ -0,0 +1,160 @@
+/**
+Hot path instrumentation.
+
+Counts events and times phases of the assignment model and the search, and writes a profile record for every search iteration. Instrumentation is selected at compile time by the INSTRUMENT definition:
+	INSTRUMENT_OFF: all instrumentation macros expand to nothing, so the hot paths are unchanged
+	INSTRUMENT_COUNTERS: event counters and wall clock phase timers
+	INSTRUMENT_HARDWARE: event counters and phase timers along with Linux hardware performance counters (instructions, cycles, cache references, and cache misses) for every worker thread
+
+The instrumented code never calls the profiler directly, but only through the macros defined at the end of this file. Most events are counted with PROFILE_COUNT, while inner loops should find the worker's block once with PROFILE_LOCAL and then count with PROFILE_LOCAL_COUNT, which is a single addition.
+
+Each worker thread owns a block of counters and timers which only it writes, so counting requires no locks or atomic operations. Blocks are summed when a record is written, which must only happen while no tasks are running, such as between search iterations. Phase timers measure wall time on the thread which runs the phase, and since phases run concurrently on several workers their totals are given in thread-seconds and may exceed the wall time of the iteration.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "thread_pool.hpp"
+
+using namespace std;
+
+extern thread_local string FILE_BASE;
+
+// Event counter IDs
+#define COUNT_CANDIDATES 0 // solutions passed to the constraint calculation
+#define COUNT_LOG_HITS 1 // solutions found in the solution log
+#define COUNT_EVALUATIONS 2 // nonlinear assignment model solutions
+#define COUNT_FW_ITERATIONS 3 // Frank-Wolfe iterations
+#define COUNT_FW_ERROR 4 // Frank-Wolfe runs ending at the error bound tolerance
+#define COUNT_FW_CHANGE 5 // Frank-Wolfe runs ending at the flow and waiting time change tolerances
+#define COUNT_FW_CUTOFF 6 // Frank-Wolfe runs ending at the iteration cutoff
+#define COUNT_CONSTANT 7 // constant-cost assignment model solutions
+#define COUNT_DESTINATIONS 8 // single-destination label setting passes
+#define COUNT_HEAP_PUSHES 9 // arc queue pushes (including decreased keys)
+#define COUNT_HEAP_POPS 10 // arc queue pops
+#define COUNT_STALE_POPS 11 // arc queue pops of already processed arcs
+#define COUNT_ATTRACTIVE 12 // arcs added to an attractive set
+#define COUNTERS 13 // number of event counters
+
+// Phase timer IDs
+#define TIME_CONSTANT 0 // constant-cost assignment model
+#define TIME_LABEL 1 // label setting
+#define TIME_LOAD 2 // flow loading
+#define TIME_REDUCTION 3 // summing single-destination flows
+#define TIME_UPDATE 4 // Frank-Wolfe solution and cost updates
+#define TIME_LINE_SEARCH 5 // Frank-Wolfe line search and conjugate direction
+#define TIME_LOCK_WAIT 6 // waiting for contended locks
+#define TIMERS 7 // number of phase timers
+
+// Hardware counter IDs
+#define HARDWARE_INSTRUCTIONS 0 // retired instructions
+#define HARDWARE_CYCLES 1 // CPU cycles
+#define HARDWARE_CACHE_REFERENCES 2 // last level cache references
+#define HARDWARE_CACHE_MISSES 3 // last level cache misses
+#define HARDWARE_COUNTERS 4 // number of hardware counters
+
+// Output file names
+#define PROFILE_CSV_FILE "log/profile.csv"
+#define PROFILE_JSON_FILE "log/profile.jsonl"
+
+// Structure declarations
+struct ProfileBlock;
+struct Profiler;
+struct ProfileTimer;
+struct ProfiledGuard;
+
+extern Profiler Profile;
+
+/// Counters and timers owned by a single worker, aligned to keep workers from sharing cache lines.
+struct alignas(64) ProfileBlock
+{
+	// Public attributes
+	long long counts[COUNTERS] = {}; // event counter totals
+	long long nanoseconds[TIMERS] = {}; // phase timer totals
+	int hardware[HARDWARE_COUNTERS] = { -1, -1, -1, -1 }; // hardware counter file descriptors (-1 if not open)
+	bool hardware_opened = false; // whether hardware counters have been requested for this worker
+};
+
+/**
+Profiler class.
+
+Holds one block for each worker of the thread pool, along with the totals at the time of the last record so that each record covers only a single iteration.
+*/
+struct Profiler
+{
+	// Public attributes
+	vector<ProfileBlock> blocks; // counters and timers of each worker
+	vector<long long> last_counts; // summed event counters at the last record
+	vector<long long> last_nanoseconds; // summed phase timers at the last record
+	vector<long long> last_hardware; // summed hardware counters at the last record
+	chrono::steady_clock::time_point last_time; // time of the last record
+	ofstream csv_file; // per-iteration CSV output
+	ofstream json_file; // per-iteration JSON lines output
+	bool hardware_failed = false; // whether a hardware counter could not be opened
+
+	// Public methods
+	~Profiler(); // destructor closes any hardware counters
+	void start(int); // clears all counters for a given number of workers and opens the output files
+	ProfileBlock &local(); // returns the calling worker's block, opening its hardware counters if necessary
+	void count(int, long long); // adds to an event counter of the calling worker
+	void add_time(int, long long); // adds nanoseconds to a phase timer of the calling worker
+	void open_hardware(ProfileBlock &); // opens the hardware counters of the calling worker
+	void close_hardware(); // closes the hardware counters of all workers
+	void record(int); // writes the changes since the last record for a given search iteration
+};
+
+/// Scoped phase timer, which adds its lifetime (or the time until it is stopped) to a phase timer of the calling worker.
+struct ProfileTimer
+{
+	// Public attributes
+	int timer; // phase timer ID (-1 once stopped)
+	chrono::steady_clock::time_point start; // time at which the timer started
+
+	// Public methods
+	ProfileTimer(int); // constructor starts timing a given phase
+	~ProfileTimer(); // destructor stops the timer if it is still running
+	void stop(); // adds the elapsed time to the phase timer
+};
+
+/**
+Scoped lock guard which times waiting.
+
+Behaves like lock_guard, except that if the lock is already held then the time spent waiting for it is added to the lock wait timer. Uncontended locks are acquired without reading the clock.
+*/
+struct ProfiledGuard
+{
+	// Public attributes
+	mutex &lock; // guarded lock
+
+	// Public methods
+	ProfiledGuard(mutex &); // constructor acquires the lock
+	~ProfiledGuard(); // destructor releases the lock
+};
+
+// Instrumentation macros
+#if INSTRUMENT == INSTRUMENT_OFF
+#define PROFILE_START(workers)
+#define PROFILE_COUNT(counter, amount)
+#define PROFILE_LOCAL(name)
+#define PROFILE_LOCAL_COUNT(name, counter, amount)
+#define PROFILE_SCOPE(name, timer)
+#define PROFILE_STOP(name)
+#define PROFILE_RECORD(iteration)
+typedef lock_guard<mutex> profiled_guard;
+#else
+#define PROFILE_START(workers) Profile.start(workers) // clears all counters for a given number of workers
+#define PROFILE_COUNT(counter, amount) Profile.count(counter, amount) // adds to an event counter
+#define PROFILE_LOCAL(name) ProfileBlock &name = Profile.local() // finds the calling worker's block
+#define PROFILE_LOCAL_COUNT(name, counter, amount) (name.counts[counter] += (amount)) // adds to an event counter of a block found with PROFILE_LOCAL
+#define PROFILE_SCOPE(name, timer) ProfileTimer name(timer) // times the rest of the enclosing scope
+#define PROFILE_STOP(name) name.stop() // stops a scoped timer early
+#define PROFILE_RECORD(iteration) Profile.record(iteration) // writes the record of a search iteration
+typedef ProfiledGuard profiled_guard;
+#endif
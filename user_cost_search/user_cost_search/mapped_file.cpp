@@ -0,0 +1,78 @@
+/// Memory-mapped file class methods.
+
+#include "mapped_file.hpp"
+
+/// Memory-mapped file destructor unmaps the file.
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+/**
+Maps a file into memory.
+
+Requires the file's name.
+
+Returns true if the file was opened and false otherwise. Any previously opened file is closed first.
+*/
+bool MappedFile::open(const string &file_name)
+{
+	close();
+
+#if MAPPED_FILE_MMAP == 1
+	int descriptor = ::open(file_name.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		return false;
+
+	struct stat status;
+	if (fstat(descriptor, &status) != 0)
+	{
+		::close(descriptor);
+		return false;
+	}
+	size = status.st_size;
+
+	// Mapping an empty file is not allowed, but there is nothing to read anyway
+	if (size > 0)
+	{
+		void * mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (mapping == MAP_FAILED)
+		{
+			::close(descriptor);
+			size = 0;
+			return false;
+		}
+		madvise(mapping, size, MADV_SEQUENTIAL);
+		data = (const char *) mapping;
+	}
+
+	// The mapping remains valid after the descriptor is closed
+	::close(descriptor);
+	return true;
+#else
+	ifstream in_file(file_name, ios_base::binary | ios_base::ate);
+	if (in_file.is_open() == false)
+		return false;
+	buffer.resize(in_file.tellg());
+	in_file.seekg(0);
+	in_file.read(buffer.data(), buffer.size());
+	size = buffer.size();
+	if (size > 0)
+		data = buffer.data();
+	return true;
+#endif
+}
+
+/// Unmaps the file, if one is open.
+void MappedFile::close()
+{
+#if MAPPED_FILE_MMAP == 1
+	if (data != nullptr)
+		munmap((void *) data, size);
+#else
+	buffer.clear();
+	buffer.shrink_to_fit();
+#endif
+	data = nullptr;
+	size = 0;
+}
@@ -0,0 +1,46 @@
+/**
+Read-only memory-mapped files.
+
+Used to read binary snapshots and data files directly from the operating system's page cache without copying them into a separate buffer. POSIX systems use mmap, while other systems fall back on reading the whole file into memory.
+*/
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP 1
+#else
+#define MAPPED_FILE_MMAP 0
+#endif
+
+using namespace std;
+
+// Structure declarations
+struct MappedFile;
+
+/**
+Memory-mapped file class.
+
+The file's contents are available as a read-only character array from open() until close() or destruction. An empty file is opened successfully with a null data pointer.
+*/
+struct MappedFile
+{
+	// Public attributes
+	const char * data = nullptr; // beginning of the file's contents
+	size_t size = 0; // size of the file in bytes
+	vector<char> buffer; // copy of the file's contents (only used without mmap)
+
+	// Public methods
+	MappedFile() = default; // default constructor opens no file
+	MappedFile(const MappedFile &) = delete; // copying would unmap the file twice
+	~MappedFile(); // destructor unmaps the file
+	bool open(const string &); // maps a given file, returning whether it succeeded
+	void close(); // unmaps the file
+};
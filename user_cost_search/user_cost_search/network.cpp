@@ -3,307 +3,206 @@
 /**
 Network constructor to automatically build network from data files.
 
-Reads the contents of these files and uses them to fill its own line, node, and arc lists, while also initializing those objects.
+Loads the input data (from the data snapshot if it is up to date, and otherwise from the data files) and uses them to build the network.
 */
 Network::Network()
 {
-	// Read problem file to get time horizon
-	double horizon = 1440.0; // default to whole 24 hours
-	ifstream problem_file;
-	problem_file.open(FILE_BASE + PROBLEM_FILE);
-	if (problem_file.is_open())
+	// Load input data
+	Input = new InputData();
+	if (Input->load() == false)
 	{
-		string line, piece; // whole line and line element being read
-		getline(problem_file, line); // skip comment 
-		getline(problem_file, line); // skip elements line
-		getline(problem_file, line); // get time horizon line
-
-		stringstream stream(line);
-		getline(stream, piece, '\t'); // Name
-		getline(stream, piece, '\t'); // Horizon
-		horizon = stod(piece); // get time horizon value
-
-		problem_file.close();
-	}
-	else
-	{
-		cout << "Problem file failed to open." << endl;
 		cin.get();
-		exit(FILE_NOT_FOUND);
+		exit(INCORRECT_FILE);
 	}
 
-	// Read node file and create node lists
-	ifstream node_file;
-	node_file.open(FILE_BASE + NODE_FILE);
-	if (node_file.is_open())
-	{
-		string line, piece; // whole line and line element being read
-		getline(node_file, line); // skip comment line
-
-		while (node_file.eof() == false)
-		{
-			// Get whole line as a string stream
-			getline(node_file, line);
-			if (line.size() == 0)
-				// Break for blank line at file end
-				break;
-			stringstream stream(line);
-
-			// Go through each piece of the line
-			getline(stream, piece, '\t'); // ID
-			int node_id = stoi(piece);
-			getline(stream, piece, '\t'); // Name
-			getline(stream, piece, '\t'); // Type
-			int node_type = stoi(piece);
-			getline(stream, piece, '\t'); // Line
-			getline(stream, piece, '\t'); // Value
-			double node_value = stod(piece);
-
-			// Create a node object and add it to the appropriate network lists
-			Node * new_node = new Node(node_id, node_value);
-			nodes.push_back(new_node);
-			switch (node_type)
-			{
-				case STOP_NODE:
-					stop_nodes.push_back(new_node);
-					core_nodes.push_back(new_node);
-					break;
-				case BOARDING_NODE:
-					boarding_nodes.push_back(new_node);
-					core_nodes.push_back(new_node);
-					break;
-				case POPULATION_NODE:
-					population_nodes.push_back(new_node);
-					break;
-				case FACILITY_NODE:
-					facility_nodes.push_back(new_node);
-					break;
-			}
-		}
+	build();
+}
 
-		node_file.close();
-	}
-	else
-	{
-		cout << "Node file failed to open." << endl;
-		cin.get();
-		exit(FILE_NOT_FOUND);
-	}
+/// Network constructor to build a network from input data which have already been loaded (or generated), taking ownership of the input data.
+Network::Network(InputData * input_in)
+{
+	Input = input_in;
+	build();
+}
 
-	// Read vehicle file and record the information required to define the vehicle types and lines
-	
-	ifstream vehicle_file;
-	vehicle_file.open(FILE_BASE + VEHICLE_FILE);
-	if (vehicle_file.is_open())
+/// Uses the input data to fill the network's own line, node, and arc lists, while also initializing those objects.
+void Network::build()
+{
+	// Create node lists
+	for (int i = 0; i < Input->node_id.size(); i++)
 	{
-		string line, piece; // whole line and line element being read
-		getline(vehicle_file, line); // skip comment line
-
-		while (vehicle_file.eof() == false)
+		// Create a node object and add it to the appropriate network lists
+		Node * new_node = new Node(Input->node_id[i], Input->node_value[i]);
+		nodes.push_back(new_node);
+		switch (Input->node_type[i])
 		{
-			// Get whole line as a string stream
-			getline(vehicle_file, line);
-			if (line.size() == 0)
-				// Break for blank line at file end
+			case STOP_NODE:
+				stop_nodes.push_back(new_node);
+				core_nodes.push_back(new_node);
+				break;
+			case BOARDING_NODE:
+				boarding_nodes.push_back(new_node);
+				core_nodes.push_back(new_node);
+				break;
+			case POPULATION_NODE:
+				population_nodes.push_back(new_node);
+				break;
+			case FACILITY_NODE:
+				facility_nodes.push_back(new_node);
 				break;
-			stringstream stream(line);
-
-			// Go through each piece of the line
-			getline(stream, piece, '\t'); // Type
-			getline(stream, piece, '\t'); // Name
-			getline(stream, piece, '\t'); // UB
-			int vehicle_bound = stoi(piece);
-			getline(stream, piece, '\t'); // Seating
-			double vehicle_cap = stod(piece);
-			getline(stream, piece, '\t'); // Cost
-
-			// Create a new vehicle type
-			Vehicle * new_vehicle = new Vehicle(vehicle_bound, vehicle_cap);
-			vehicles.push_back(new_vehicle);
 		}
-
-		vehicle_file.close();
 	}
-	else
+
+	// Create vehicle types
+	for (int i = 0; i < Input->vehicle_bound.size(); i++)
 	{
-		cout << "Vehicle file failed to open." << endl;
-		cin.get();
-		exit(FILE_NOT_FOUND);
+		Vehicle * new_vehicle = new Vehicle(Input->vehicle_bound[i], Input->vehicle_capacity[i]);
+		vehicles.push_back(new_vehicle);
 	}
 
-	// Read transit file and create line list
-	ifstream transit_file;
-	transit_file.open(FILE_BASE + TRANSIT_FILE);
-	if (transit_file.is_open())
+	// Create line list
+	for (int i = 0; i < Input->line_type.size(); i++)
 	{
-		string line, piece; // whole line and line element being read
-		getline(transit_file, line); // skip comment line
+		int vehicle_type = Input->line_type[i];
+		Line * new_line = new Line(vehicle_type, Input->line_lb[i], Input->line_ub[i], Input->line_circuit[i], vehicles[vehicle_type]->capacity, Input->line_scaling[i], Input->horizon);
+		lines.push_back(new_line);
+	}
 
-		while (transit_file.eof() == false)
+	// Create arc lists
+	for (int i = 0; i < Input->arc_id.size(); i++)
+	{
+		int arc_type = Input->arc_type[i];
+		int arc_line = Input->arc_line[i];
+		int arc_tail = Input->arc_tail[i];
+		int arc_head = Input->arc_head[i];
+
+		// Create an arc object and add it to the appropriate network, node, and line lists
+		Arc * new_arc = new Arc(Input->arc_id[i], nodes[arc_tail], nodes[arc_head], Input->arc_time[i], arc_line, arc_type);
+		if (arc_type == ACCESS_ARC)
 		{
-			// Get whole line as a string stream
-			getline(transit_file, line);
-			if (line.size() == 0)
-				// Break for blank line at file end
-				break;
-			stringstream stream(line);
-
-			// Go through each piece of the line
-			int vehicle_type;
-			double circuit_time;
-			double day_fraction;
-			int lb;
-			int ub;
-			try
+			// An access arc goes into the main access arc list, its tail's outgoing access arc set, and its head's incoming access arc set
+			access_arcs.push_back(new_arc);
+			nodes[arc_tail]->access_out.push_back(new_arc);
+		}
+		else
+		{
+			// A non-access arc goes into the main core arc list, its tail's outgoing/incoming core arc sets, and its head's incoming core arc set
+			core_arcs.push_back(new_arc);
+			nodes[arc_tail]->core_out.push_back(new_arc);
+			nodes[arc_head]->core_in.push_back(new_arc);
+			if (arc_type == LINE_ARC)
 			{
-				getline(stream, piece, '\t'); // ID
-				getline(stream, piece, '\t'); // Name
-				getline(stream, piece, '\t'); // Type
-				vehicle_type = stoi(piece);
-				getline(stream, piece, '\t'); // Fleet
-				getline(stream, piece, '\t'); // Circuit
-				circuit_time = stod(piece);
-				getline(stream, piece, '\t'); // Scaling
-				day_fraction = stod(piece);
-				getline(stream, piece, '\t'); // LB
-				lb = stoi(piece);
-				getline(stream, piece, '\t'); // UB
-				ub = stoi(piece);
+				// A line arc additionally goes into the network's line arc list and its line's line arc list
+				line_arcs.push_back(new_arc);
+				lines[arc_line]->in_vehicle.push_back(new_arc);
 			}
-			catch (out_of_range &e) {};
-
-			// Create a line object and add it to the list
-			Line * new_line = new Line(vehicle_type, lb, ub, circuit_time, vehicles[vehicle_type]->capacity, day_fraction, horizon);
-			lines.push_back(new_line);
+			if (arc_type == BOARDING_ARC)
+				// A boarding arc additionally goes into its line's boarding arc list
+				lines[arc_line]->boarding.push_back(new_arc);
+			if (arc_type == WALKING_ARC)
+				// A walking arc additionally goes into the network's walking arc list
+				walking_arcs.push_back(new_arc);
 		}
 
-		transit_file.close();
-	}
-	else
-	{
-		cout << "Transit file failed to open." << endl;
-		cin.get();
-		exit(FILE_NOT_FOUND);
+		// Add a very small cost to boarding and alighting arcs
+		if ((arc_type == BOARDING_ARC) || (arc_type == ALIGHTING_ARC))
+			new_arc->cost += EPSILON;
 	}
 
-	// Read arc file and create arc lists
-	ifstream arc_file;
-	arc_file.open(FILE_BASE + ARC_FILE);
-	if (arc_file.is_open())
-	{
-		string line, piece; // whole line and line element being read
-		getline(arc_file, line); // skip comment line
+	// Find each stop node's position in the stop node list
+	vector<int> stop_position(nodes.size(), NO_ID);
+	for (int i = 0; i < stop_nodes.size(); i++)
+		stop_position[stop_nodes[i]->id] = i;
 
-		while (arc_file.eof() == false)
-		{
-			// Get whole line as a string stream
-			getline(arc_file, line);
-			if (line.size() == 0)
-				// Break for blank line at file end
-				break;
-			stringstream stream(line);
-
-			// Go through each piece of the line
-			getline(stream, piece, '\t'); // ID
-			int arc_id = stoi(piece);
-			getline(stream, piece, '\t'); // Type
-			int arc_type = stoi(piece);
-			getline(stream, piece, '\t'); // Line
-			int arc_line = stoi(piece);
-			getline(stream, piece, '\t'); // Tail
-			int arc_tail = stoi(piece);
-			getline(stream, piece, '\t'); // Head
-			int arc_head = stoi(piece);
-			getline(stream, piece, '\t'); // Time
-			double arc_time = stod(piece);
-
-			// Create an arc object and add it to the appropriate network, node, and line lists
-			Arc * new_arc = new Arc(arc_id, nodes[arc_tail], nodes[arc_head], arc_time, arc_line, arc_type);
-			if (arc_type == ACCESS_ARC)
-			{
-				// An access arc goes into the main access arc list, its tail's outgoing access arc set, and its head's incoming access arc set
-				access_arcs.push_back(new_arc);
-				nodes[arc_tail]->access_out.push_back(new_arc);
-			}
-			else
-			{
-				// A non-access arc goes into the main core arc list, its tail's outgoing/incoming core arc sets, and its head's incoming core arc set
-				core_arcs.push_back(new_arc);
-				nodes[arc_tail]->core_out.push_back(new_arc);
-				nodes[arc_head]->core_in.push_back(new_arc);
-				if (arc_type == LINE_ARC)
-				{
-					// A line arc additionally goes into the network's line arc list and its line's line arc list
-					line_arcs.push_back(new_arc);
-					lines[arc_line]->in_vehicle.push_back(new_arc);
-				}
-				if (arc_type == BOARDING_ARC)
-					// A boarding arc additionally goes into its line's boarding arc list
-					lines[arc_line]->boarding.push_back(new_arc);
-				if (arc_type == WALKING_ARC)
-					// A walking arc additionally goes into the network's walking arc list
-					walking_arcs.push_back(new_arc);
-			}
+	// Create the sparse travel demand lists
+	vector<int> destinations(Input->od_destination.size()); // destination stop list position of each nonzero O/D pair, in file order
+	for (int i = 0; i < destinations.size(); i++)
+		destinations[i] = stop_position[Input->od_destination[i]];
+	build_od_lists(Input->od_origin, destinations, Input->od_volume);
 
-			// Add a very small cost to boarding and alighting arcs
-			if ((arc_type == BOARDING_ARC) || (arc_type == ALIGHTING_ARC))
-				new_arc->cost += EPSILON;
-		}
+	build_core_arrays();
+}
 
-		arc_file.close();
-	}
-	else
+/**
+Builds the sparse travel demand lists from a list of O/D pairs.
+
+Requires vectors of the origin node IDs, destination stop list positions, and travel volumes of the O/D pairs, respectively.
+
+The pairs are grouped by destination using a counting sort, which keeps pairs with the same destination in their original order. The total incoming demand of each destination is also recorded.
+*/
+void Network::build_od_lists(const vector<int> &origins, const vector<int> &destinations, const vector<double> &volumes)
+{
+	// Count the pairs for each destination and find where each destination's pairs begin
+	od_start.assign(stop_nodes.size() + 1, 0);
+	for (int i = 0; i < destinations.size(); i++)
+		od_start[destinations[i] + 1]++;
+	for (int d = 0; d < stop_nodes.size(); d++)
+		od_start[d + 1] += od_start[d];
+
+	// Place each pair in its destination's group
+	vector<int> next(od_start.begin(), od_start.end() - 1); // next free position in each destination's group
+	od_origin.resize(origins.size());
+	od_volume.resize(volumes.size());
+	for (int i = 0; i < destinations.size(); i++)
 	{
-		cout << "Arc file failed to open." << endl;
-		cin.get();
-		exit(FILE_NOT_FOUND);
+		int k = next[destinations[i]]++;
+		od_origin[k] = origins[i];
+		od_volume[k] = volumes[i];
 	}
 
-	// Initialize empty stop file travel demand lists
-	for (int i = 0; i < stop_nodes.size(); i++)
-		stop_nodes[i]->incoming_demand.resize(stop_nodes.size(), 0.0);
+	// Total the demand of each destination
+	stop_demand.assign(stop_nodes.size(), 0.0);
+	for (int d = 0; d < stop_nodes.size(); d++)
+		for (int k = od_start[d]; k < od_start[d + 1]; k++)
+			stop_demand[d] += od_volume[k];
+}
 
-	// Read OD file and create travel demand lists for nodes
-	ifstream od_file;
-	od_file.open(FILE_BASE + OD_FILE);
-	if (od_file.is_open())
-	{
-		string line, piece; // whole line and line element being read
-		getline(od_file, line); // skip comment line
+/**
+Builds the flat core network representation.
 
-		while (od_file.eof() == false)
-		{
-			// Get whole line as a string stream
-			getline(od_file, line);
-			if (line.size() == 0)
-				// Break for blank line at file end
-				break;
-			stringstream stream(line);
-
-			// Go through each piece of the line
-			getline(stream, piece, '\t'); // ID
-			getline(stream, piece, '\t'); // Origin
-			int origin_node = stoi(piece);
-			getline(stream, piece, '\t'); // Destination
-			int destination_node = stoi(piece);
-			getline(stream, piece, '\t'); // Volume
-			double travel_volume = stod(piece);
-
-			// Read travel volume from the origin into its destination's travel demand list
-			nodes[destination_node]->incoming_demand[origin_node] = travel_volume;
-		}
+Copies the attributes of each core arc into contiguous arrays indexed by arc ID, and gathers the incoming and outgoing arc lists of all core nodes into compressed sparse row arrays. Each node's arcs are kept in the same order as in its Node object.
+*/
+void Network::build_core_arrays()
+{
+	// Copy arc attributes
+	arc_tail.resize(core_arcs.size());
+	arc_head.resize(core_arcs.size());
+	arc_cost.resize(core_arcs.size());
+	arc_line.resize(core_arcs.size());
+	arc_type.resize(core_arcs.size());
+	for (int i = 0; i < core_arcs.size(); i++)
+	{
+		int id = core_arcs[i]->id;
+		arc_tail[id] = core_arcs[i]->tail->id;
+		arc_head[id] = core_arcs[i]->head->id;
+		arc_cost[id] = core_arcs[i]->cost;
+		arc_line[id] = core_arcs[i]->line;
+		arc_type[id] = core_arcs[i]->type;
 	}
-	else
+
+	// Gather incoming and outgoing arc lists
+	in_start.resize(core_nodes.size() + 1);
+	out_start.resize(core_nodes.size() + 1);
+	in_arcs.clear();
+	out_arcs.clear();
+	for (int i = 0; i < core_nodes.size(); i++)
 	{
-		cout << "OD file failed to open." << endl;
-		cin.get();
-		exit(FILE_NOT_FOUND);
+		in_start[i] = in_arcs.size();
+		for (int j = 0; j < core_nodes[i]->core_in.size(); j++)
+			in_arcs.push_back(core_nodes[i]->core_in[j]->id);
+		out_start[i] = out_arcs.size();
+		for (int j = 0; j < core_nodes[i]->core_out.size(); j++)
+			out_arcs.push_back(core_nodes[i]->core_out[j]->id);
 	}
+	in_start[core_nodes.size()] = in_arcs.size();
+	out_start[core_nodes.size()] = out_arcs.size();
 }
 
-/// Network destructor deletes all Node, Arc, and Line objects created by the constructor.
+/// Network destructor deletes the input data and all Node, Arc, and Line objects created by the constructor.
 Network::~Network()
 {
+	delete Input;
+
 	for (int i = 0; i < lines.size(); i++)
 		delete lines[i];
 
@@ -339,6 +238,7 @@ Arc::Arc(int id_in, Node * tail_in, Node * head_in, double cost_in, int line_in,
 	head = head_in;
 	cost = cost_in;
 	line = line_in;
+	type = type_in;
 	if (type_in == BOARDING_ARC)
 		boarding = true;
 	else
@@ -6,6 +6,7 @@ Includes a Network, Arc, Node, Line, and Vehicle class. Objects from these class
 
 #pragma once
 
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -13,10 +14,11 @@ Includes a Network, Arc, Node, Line, and Vehicle class. Objects from these class
 #include <unordered_map>
 #include <vector>
 #include "DEFINITIONS.hpp"
+#include "input_data.hpp"
 
 using namespace std;
 
-extern string FILE_BASE;
+extern thread_local string FILE_BASE;
 
 // Structure declarations
 struct Network;
@@ -28,13 +30,18 @@ struct Vehicle;
 /**
 A class for the network representation of the public transit system.
 
-Its constructor reads the node and arc data files and uses them to define Node and Arc objects. Pointers to these objects are then stored in different lists, partitioned depending on their function, for use in the objective and constraint function calculations. Line and Vehicle lists are similarly generated.
+Its constructor loads the input data and uses them to define Node and Arc objects. Pointers to these objects are then stored in different lists, partitioned depending on their function, for use in the objective and constraint function calculations. Line and Vehicle lists are similarly generated.
 
 Most of the network objects are partitioned into a "core" set which is used for all purposes (including stop/boarding nodes and line/boarding/alighting/walking arcs), and an "access" set which is only needed for the primary care access metrics (including population/facility nodes and their associated walking arcs). Only the core set needs to be considered for the constraint calculation, while the access sets must be added in for the objective.
+
+Travel demands are stored in compressed sparse row form by destination, with only the nonzero O/D pairs included: the pairs ending at the stop in position d of the stop node list are od_origin[k] and od_volume[k] for k from od_start[d] through od_start[d+1]-1.
+
+The core network is additionally stored in a flat form for use in the assignment model's inner loops. Arc attributes are kept in contiguous arrays indexed by arc ID, and the incoming and outgoing arcs of each core node are kept in compressed sparse row form: the IDs of the arcs entering node i are in_arcs[in_start[i]] through in_arcs[in_start[i+1]-1], and similarly for the outgoing arcs.
 */
 struct Network
 {
 	// Public attributes
+	InputData * Input; // pointer to the input data, which also include the initial fleet sizes and the model parameters
 	vector<Line *> lines; // pointers to each line, arranged in the same order as the solution vector
 	vector<Vehicle *> vehicles; // pointers to each vehicle type
 	vector<Node *> nodes; // pointers to all nodes
@@ -48,9 +55,30 @@ struct Network
 	vector<Arc *> walking_arcs; // pointers to all core network walking arcs
 	vector<Arc *> access_arcs; // pointers to access network walking arcs
 
+	// Public attributes (flat core network representation)
+	vector<int> arc_tail; // tail node ID of each core arc
+	vector<int> arc_head; // head node ID of each core arc
+	vector<double> arc_cost; // constant travel time of each core arc
+	vector<int> arc_line; // line ID of each core arc (-1 if N/A)
+	vector<int> arc_type; // type ID of each core arc
+	vector<int> in_start; // position of each core node's first incoming arc in the incoming arc list, followed by the list's total size
+	vector<int> in_arcs; // IDs of the incoming arcs of all core nodes, grouped by head
+	vector<int> out_start; // position of each core node's first outgoing arc in the outgoing arc list, followed by the list's total size
+	vector<int> out_arcs; // IDs of the outgoing arcs of all core nodes, grouped by tail
+
+	// Public attributes (sparse travel demand)
+	vector<int> od_start; // position of each destination's first O/D pair in the O/D lists, in the same order as the stop node list, followed by the lists' total size
+	vector<int> od_origin; // origin node ID of each nonzero O/D pair, grouped by destination
+	vector<double> od_volume; // travel volume of each nonzero O/D pair, grouped by destination
+	vector<double> stop_demand; // total incoming travel demand of each stop node, in the same order as the stop node list
+
 	// Public methods
 	Network(); // constructor uses input data file names from the definition header to automatically build the network
-	~Network(); // destructor deletes all Node, Arc, and Line objects
+	Network(InputData *); // constructor builds the network from already loaded input data, which it takes ownership of
+	~Network(); // destructor deletes the input data and all Node, Arc, and Line objects
+	void build(); // builds all network objects and lists from the input data
+	void build_od_lists(const vector<int> &, const vector<int> &, const vector<double> &); // builds the sparse travel demand lists from lists of origins, destinations, and volumes
+	void build_core_arrays(); // builds the flat core network representation from the core Node and Arc objects
 };
 
 /**
@@ -64,7 +92,6 @@ struct Node
 	vector<Arc *> core_out; // pointers to outgoing arcs that belong to the core network
 	vector<Arc *> core_in; // pointers to incoming arcs that belong to the core network
 	vector<Arc *> access_out; // pointers to outgoing arcs that belong to the access network
-	vector<double> incoming_demand; // (stop nodes only) travel demands from every other stop node, in same order as network's core node list
 	int id; // ID number (should match position in node list)
 	double value; // value relevant to node type (population of a population center, weight of a facility)
 
@@ -86,6 +113,7 @@ struct Arc
 	int id; // ID number (should match position in arc list)
 	double cost; // constant travel time
 	int line = -1; // line ID (-1 if N/A)
+	int type; // arc type ID
 	bool boarding = false; // whether or not this is a boarding arc
 
 	// Public methods
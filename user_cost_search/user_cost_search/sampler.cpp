@@ -0,0 +1,68 @@
+/**
+The main function for the objective topology sampler, which tabulates the objective over slices of the solution space around the initial solution of an instance (see topology_sampler.hpp).
+
+The instance is read from the data/ folder of the working directory, as for the user cost search, and the results are written to its log/ folder. Every sampled solution is added to the solution log, so a later search of the same instance will not need to evaluate them again.
+
+Command line options:
+	-p <pairs>: number of random line pairs to sample (default 10)
+	-r <radius>: largest change to either line's fleet size within a slice (default 4)
+	-s <seed>: random seed for choosing line pairs (default 1)
+	-t <threads>: number of worker threads to use (default 0, meaning one per hardware thread)
+*/
+
+#include <cstring>
+#include <iostream>
+#include "DEFINITIONS.hpp"
+#include "search.hpp"
+#include "thread_pool.hpp"
+#include "topology_sampler.hpp"
+
+using namespace std;
+
+// Global thread pool pointer
+ThreadPool * Pool;
+
+// Global file base name
+thread_local string FILE_BASE = "";
+
+/// Sampler driver
+int main(int argc, char *argv[])
+{
+	// Read command line options
+	int pairs = 10;
+	int radius = 4;
+	unsigned int seed = 1;
+	int threads = DEFAULT_THREADS;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-p") == 0) && (i + 1 < argc))
+			pairs = max(1, atoi(argv[++i]));
+		else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+			radius = max(1, atoi(argv[++i]));
+		else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+			seed = atoi(argv[++i]);
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+			threads = atoi(argv[++i]);
+		else
+		{
+			cout << "Unrecognized option " << argv[i] << "." << endl;
+			return INCORRECT_OPTION;
+		}
+	}
+
+	// Initialize worker threads and search object
+	Pool = new ThreadPool(threads);
+	Search * Solver = new Search();
+
+	// Sample and report the objective topology
+	TopologySampler Sampler(Solver, radius, seed);
+	Sampler.sample(pairs);
+	Sampler.report();
+	int code = SUCCESSFUL_EXIT;
+	if (Sampler.write() == false)
+		code = WRITE_FAILED;
+
+	delete Solver;
+	delete Pool;
+	return code;
+}
@@ -3,68 +3,35 @@
 #include "search.hpp"
 
 /// Search constructor initializes Network, Objective, and Constraint objects and loads search parameters.
-Search::Search()
+Search::Search() : Search(new Network())
 {
-	Net = new Network(); // network object
+}
+
+/// Search constructor for an existing network, which the search takes ownership of, initializes the Constraint object and loads search parameters.
+Search::Search(Network * net_in)
+{
+	Net = net_in; // network object
 	Con = new Constraint(Net); // constraint function object
 	sol_size = Net->lines.size(); // get solution vector size
 	srand(time(NULL)); // seed random number generator
 
-	// Read initial fleet sizes from transit file
-	ifstream transit_file;
-	transit_file.open(FILE_BASE + TRANSIT_FILE);
-	if (transit_file.is_open())
-	{
-		string line, piece; // whole line and line element being read
-		getline(transit_file, line); // skip comment line
-
-		while (transit_file.eof() == false)
-		{
-			// Get whole line as a string stream
-			getline(transit_file, line);
-			if (line.size() == 0)
-				// Break for blank line at file end
-				break;
-			stringstream stream(line);
-
-			// Go through each piece of the line
-			int fleet;
-			try
-			{
-				getline(stream, piece, '\t'); // ID
-				getline(stream, piece, '\t'); // Name
-				getline(stream, piece, '\t'); // Type
-				getline(stream, piece, '\t'); // Fleet
-				fleet = stoi(piece);
-				getline(stream, piece, '\t'); // Circuit
-				getline(stream, piece, '\t'); // Scaling
-				getline(stream, piece, '\t'); // LB
-				getline(stream, piece, '\t'); // UB
-			}
-			catch (out_of_range &e) {};
-
-			// Add fleet size to solution vector
-			sol_current.push_back(fleet);
-		}
-
-		transit_file.close();
-	}
-	else
-	{
-		cout << "Transit file failed to open." << endl;
-		cin.get();
-		exit(FILE_NOT_FOUND);
-	}
+	// Get initial fleet sizes from transit data
+	sol_current = Net->Input->line_fleet;
 
 	// Set best and initial objectives
 	sol_best = sol_current;
 	obj_current = INFINITY;
 	obj_best = INFINITY;
+
+	// Clear the profile counters and trace buffers for this network's search
+	PROFILE_START(Pool->worker_count);
+	TRACE_START(Pool->worker_count);
 }
 
-/// Search destructor deletes Network, Objective, and Constraint objects created by the constructor.
+/// Search destructor writes the trace file (if tracing is enabled) and deletes Network, Objective, and Constraint objects created by the constructor.
 Search::~Search()
 {
+	TRACE_WRITE();
 	delete Net;
 	delete Con;
 }
@@ -72,25 +39,7 @@ Search::~Search()
 /// Main driver of the solution algorithm. Calls main search loop and handles final output.
 void Search::solve()
 {
-	// Determine total vehicle bounds
-	max_vehicles.resize(Net->vehicles.size());
-	for (int i = 0; i < Net->vehicles.size(); i++)
-		max_vehicles[i] = Net->vehicles[i]->max_fleet;
-
-	// Determine line fleet bounds
-	line_min.resize(sol_size);
-	line_max.resize(sol_size);
-	for (int i = 0; i < sol_size; i++)
-	{
-		line_min[i] = Net->lines[i]->min_fleet;
-		line_max[i] = Net->lines[i]->max_fleet;
-	}
-
-	// Determine current total vehicle usage and establish vehicle type vector
-	vehicle_type.resize(Net->lines.size());
-	for (int i = 0; i < Net->lines.size(); i++)
-		vehicle_type[i] = Net->lines[i]->vehicle_id;
-	vehicle_totals();
+	set_bounds();
 
 	// Handle exhaustive search
 
@@ -107,13 +56,44 @@ void Search::solve()
 
 	// Initialize local search method
 	exhaustive_search();
+	if (Interrupted == true)
+		// The search is not finished, so its progress is only kept in the checkpoint
+		return;
 	sol_best = sol_current;
 	obj_best = obj_current;
 
+	// Report memory used by the assignment model's scratch space
+	cout << endl;
+	Con->Assignment->Submodel->report_memory();
+
 	// Perform final saves after search completes
 	save_data();
 }
 
+/// Determines the fleet bounds of every line and vehicle type along with the current vehicle usage.
+void Search::set_bounds()
+{
+	// Determine total vehicle bounds
+	max_vehicles.resize(Net->vehicles.size());
+	for (int i = 0; i < Net->vehicles.size(); i++)
+		max_vehicles[i] = Net->vehicles[i]->max_fleet;
+
+	// Determine line fleet bounds
+	line_min.resize(sol_size);
+	line_max.resize(sol_size);
+	for (int i = 0; i < sol_size; i++)
+	{
+		line_min[i] = Net->lines[i]->min_fleet;
+		line_max[i] = Net->lines[i]->max_fleet;
+	}
+
+	// Determine current total vehicle usage and establish vehicle type vector
+	vehicle_type.resize(Net->lines.size());
+	for (int i = 0; i < Net->lines.size(); i++)
+		vehicle_type[i] = Net->lines[i]->vehicle_id;
+	vehicle_totals();
+}
+
 /**
 Generates the solution vector resulting from a specified move.
 
@@ -147,15 +127,16 @@ void Search::vehicle_totals()
 /**
 Finds the absolute best neighbor of the current solution.
 
-Returns a move/objective value pair corresponding to the best neighbor. If no neighbor has an objective value strictly lower than the given solution (meaning that the given solution is locally optimal), the returned solution will consist of the NO_ID move pair and an infinite objective.
+Returns a move/objective value pair corresponding to the best neighbor. If no neighbor has an objective value strictly lower than the given solution (meaning that the given solution is locally optimal), the returned solution will consist of the NO_ID move pair and an infinite objective. The best neighbor's converged assignment is left in the neighbor flow attribute.
+
+Every neighbor's assignment model is warm started from the converged assignment of the current solution, and neighbors found in the solution log are not re-evaluated. Neighbors are evaluated concurrently, but the move returned is always the one that a serial search over all ADD moves followed by all DROP moves would return.
 
 This is for use in an exhaustive local search. Every possible ADD and DROP move from the given solution is considered (we do not consider SWAP moves since there are so many). Tabu rules are ignored but all other constraints are enforced.
 */
 pair<pair<int, int>, double> Search::best_neighbor()
 {
-	// Current best known neighbor objective and move
-	pair<int, int> top_move = make_pair(NO_ID, NO_ID);
-	double top_objective = INFINITY;
+	// List every move which respects the fleet bounds, with all ADD moves before all DROP moves
+	vector<pair<int, int>> moves; // candidate moves, in the order they would be considered by a serial search
 
 	// Consider every possible ADD move
 	for (int choice = 0; choice < sol_size; choice++)
@@ -167,27 +148,8 @@ pair<pair<int, int>, double> Search::best_neighbor()
 		if (current_vehicles[vehicle_type[choice]] + 1 > max_vehicles[vehicle_type[choice]])
 			// Skip ADD moves that would exceed a total vehicle bound
 			continue;
-
-		// Initialize candidate solution containers
-		vector<int> sol_candidate = make_move(choice, NO_ID); // solution vector resulting from chosen ADD
-		double obj_candidate; // objective of candidate solution
-		int feas; // candidate solution feasibility status
-
-		// Calculate its objective and create a tentative log entry
-		feas = FEAS_UNKNOWN;
-		clock_t start = clock(); // objective calculation timer
-		obj_candidate = Con->calculate(sol_candidate); // calculate objective value
-		double candidate_time = (1.0*clock() - start) / CLOCKS_PER_SEC; // objective calculation time
-
-		// Filter out moves that do not improve on the current solution or best known neighbor
-		if ((obj_candidate >= obj_current) || (obj_candidate >= top_objective))
-			continue;
-
-		// If we've made it this far, the candidate should be kept
-		top_move = make_pair(choice, NO_ID);
-		top_objective = obj_candidate;
+		moves.push_back(make_pair(choice, NO_ID));
 	}
-	cout << '.';
 
 	// Consider every possible DROP move
 	for (int choice = 0; choice < sol_size; choice++)
@@ -199,63 +161,144 @@ pair<pair<int, int>, double> Search::best_neighbor()
 		if (current_vehicles[vehicle_type[choice]] - 1 < 0)
 			// Skip DROP moves that would result in negative vehicles
 			continue;
+		moves.push_back(make_pair(NO_ID, choice));
+	}
+
+	// Current best known neighbor objective and move
+	pair<int, int> top_move = make_pair(NO_ID, NO_ID);
+	double top_objective = INFINITY;
+	int top_index = NO_ID; // position of the best known neighbor in the move list
+	mutex top_lock; // lock for the best known neighbor
+
+	/*
+	All candidates are evaluated in parallel, with each evaluation sharing the pool with the destination-level tasks of the others. A serial search keeps the first candidate to attain the lowest objective, so ties between equal objectives are broken in favor of the earlier position in the move list. Each objective is computed deterministically, so the chosen move is always the one that the serial search would have chosen.
+	*/
+	Pool->run(moves.size(), [&](int task, int worker)
+	{
+		// Once interrupted, skip any candidates not yet started, since the neighborhood search will be discarded
+		if (Interrupted == true)
+			return;
+		TRACE_SCOPE(candidate_span, "candidate", task);
 
 		// Initialize candidate solution containers
-		vector<int> sol_candidate = make_move(NO_ID, choice); // solution vector resulting from chosen DROP
+		vector<int> sol_candidate = make_move(moves[task].first, moves[task].second); // solution vector resulting from chosen move
 		double obj_candidate; // objective of candidate solution
+		pair<vector<double>, double> flows_candidate; // converged assignment of candidate solution
 		int feas; // candidate solution feasibility status
 
 		// Calculate its objective and create a tentative log entry
 		feas = FEAS_UNKNOWN;
-		clock_t start = clock(); // objective calculation timer
-		obj_candidate = Con->calculate(sol_candidate); // calculate objective value
-		double candidate_time = (1.0*clock() - start) / CLOCKS_PER_SEC; // objective calculation time
+		obj_candidate = Con->calculate(sol_candidate, flows_current, flows_candidate); // calculate objective value
 
-		// Filter out moves that do not improve on the current solution or best known neighbor
-		if ((obj_candidate >= obj_current) || (obj_candidate >= top_objective))
-			continue;
+		// Filter out moves that do not improve on the current solution
+		if (obj_candidate >= obj_current)
+			return;
 
-		// If we've made it this far, the candidate should be kept
-		top_move = make_pair(NO_ID, choice);
-		top_objective = obj_candidate;
-	}
-	cout << '.';
+		// Keep the candidate if it improves on the best known neighbor, or ties with one that comes later in the move list
+		profiled_guard guard(top_lock);
+		if ((obj_candidate < top_objective) || ((obj_candidate == top_objective) && (task < top_index)))
+		{
+			top_move = moves[task];
+			top_objective = obj_candidate;
+			top_index = task;
+			flows_neighbor.swap(flows_candidate);
+		}
+	});
 
 	// Return the best solution vector
-	cout << endl;
 	return make_pair(top_move, top_objective);
 }
 
 /**
 Conducts an exhaustive, greedy local search from the current solution.
 
-Each iteration of the search moves to the neighbor with the best objective value. The search ends when local optimality is achieved.
+The starting solution is evaluated first, after which each iteration of the search moves to the neighbor with the best objective value. The search ends when local optimality is achieved.
+
+If a checkpoint of an earlier run of the search is found then the search resumes from it instead. A checkpoint is written after a move whenever the last one is at least CHECKPOINT_INTERVAL seconds old, and again if the search is interrupted by a signal, in which case the search stops at the end of its current neighborhood search. The checkpoint is deleted once the search finishes.
 */
 void Search::exhaustive_search()
 {
+	int iterations; // number of Frank-Wolfe iterations of a re-solved assignment
+	if (read_checkpoint() == false)
+	{
+		// Evaluate the starting solution to obtain its objective and the converged assignment used to warm start its neighbors
+		pair<vector<double>, double> zero_flows(vector<double>(Net->core_arcs.size(), 0.0), 0.0);
+		obj_current = Con->calculate(sol_current, zero_flows, flows_current);
+		if (flows_current.first.empty() == true)
+			// Objective came from the solution log, so the assignment must still be solved
+			Con->evaluate(sol_current, zero_flows, flows_current, iterations);
+	}
+	checkpoint_time = chrono::steady_clock::now();
+
 	// Find best neighbor
-	cout << "\n---------- Exhaustive Search Iteration 0 ----------\n" << endl;
+	iteration_message();
 	pair<pair<int, int>, double> move = best_neighbor();
-	cout << "Making move (" << move.first.first << ',' << move.first.second << ')' << endl;
+	PROFILE_RECORD(exhaustive_iteration);
+	if (Interrupted == false)
+		move_message(move.first);
 
-	// Continue main loop until reaching local optimality
-	while (move.second < INFINITY)
+	// Continue main loop until reaching local optimality or being interrupted
+	while ((move.second < INFINITY) && (Interrupted == false))
 	{
-		clock_t start = clock(); // iteration timer
-
 		exhaustive_iteration++;
-		cout << "\n---------- Exhaustive Search Iteration " << exhaustive_iteration << " ----------\n" << endl;
-		cout << "Current user cost: " << obj_current << endl;
+		iteration_message();
 
 		// Make local move and update objective and vehicle usage
-		cout << "Making move (" << move.first.first << ',' << move.first.second << ')' << endl;
+		move_message(move.first);
 		sol_current = make_move(move.first.first, move.first.second);
 		obj_current = move.second;
+		if (flows_neighbor.first.empty() == true)
+			// Objective came from the solution log, so the assignment must still be solved from the same warm start
+			Con->evaluate(sol_current, flows_current, flows_neighbor, iterations);
+		flows_current.swap(flows_neighbor);
 		vehicle_totals();
 
+		// Save the new current solution if the last checkpoint is old enough
+		if (chrono::duration<double>(chrono::steady_clock::now() - checkpoint_time).count() >= CHECKPOINT_INTERVAL)
+			write_checkpoint();
+
 		// Repeat neighborhood search
 		move = best_neighbor();
+		PROFILE_RECORD(exhaustive_iteration);
+	}
+
+	if (Interrupted == true)
+	{
+		// Save the current solution, whose unfinished neighborhood search is repeated on resuming (with every finished candidate found in the solution log)
+		if (write_checkpoint() == true)
+		{
+			ostringstream text;
+			text << "\nSearch interrupted. Saved checkpoint at iteration " << exhaustive_iteration << '.';
+			Con->Events->message(text.str());
+		}
 	}
+	else
+		// A finished search leaves nothing to resume
+		remove_checkpoint();
+
+	// Let the evaluation log catch up before anything else is printed
+	Con->Events->flush();
+}
+
+/**
+Queues the banner of the current search iteration for the evaluation log, along with the current user cost.
+
+Messages are printed by the evaluation log's background thread, in order with its progress lines, rather than flushing the console from the search.
+*/
+void Search::iteration_message()
+{
+	ostringstream text;
+	text << "\n---------- Exhaustive Search Iteration " << exhaustive_iteration << " ----------\n\n";
+	text << "Current user cost: " << obj_current;
+	Con->Events->message(text.str());
+}
+
+/// Queues a description of a given move for the evaluation log.
+void Search::move_message(const pair<int, int> &move)
+{
+	ostringstream text;
+	text << "Making move (" << move.first << ',' << move.second << ')';
+	Con->Events->message(text.str());
 }
 
 /// Writes an output file containing only the best solution and its objective value.
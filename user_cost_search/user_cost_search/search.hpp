@@ -7,14 +7,19 @@ Called by the main() function after all subroutine objects have been initialized
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <csignal>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <queue>
 #include <sstream>
 #include <string>
@@ -25,20 +30,25 @@ Called by the main() function after all subroutine objects have been initialized
 #include <vector>
 #include "DEFINITIONS.hpp"
 #include "constraints.hpp"
+#include "input_data.hpp"
+#include "instrumentation.hpp"
+#include "mapped_file.hpp"
 #include "network.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 using namespace std;
 
-extern string FILE_BASE;
+extern thread_local string FILE_BASE;
+extern atomic<bool> Interrupted; // whether a SIGINT or SIGTERM has asked the search to stop
+
+// Global function prototypes
+void interrupt_search(int); // signal handler which asks the search to stop
 
 typedef pair<pair<pair<int, int>, double>, pair<pair<int, int>, double>> neighbor_pair; // structure of neighborhood search output
 typedef priority_queue<tuple<double, pair<int, int>, bool>, vector<tuple<double, pair<int, int>, bool>>, greater<tuple<double, pair<int, int>, bool>>> candidate_queue; // min-priority queue for storing objective/move/new tuples in the neighborhood search
 typedef priority_queue<pair<double, pair<int, int>>, vector<pair<double, pair<int, int>>>, greater<pair<double, pair<int, int>>>> neighbor_queue; // min-priority queue for storing objective/move pairs at the end of the neighborhood search
 
-// Global function prototypes
-string vec2str(const vector<int> &); // returns string version of integer vector
-vector<int> str2vec(string); // returns an integer vector for a given solution string
-
 /**
 Search object.
 
@@ -63,16 +73,26 @@ struct Search
 	vector<int> sol_best; // best known solution vector
 	double obj_current; // current objective value
 	double obj_best; // best known objective value
+	pair<vector<double>, double> flows_current; // converged flow vector/waiting time pair of the current solution, used to warm start all neighbors
+	pair<vector<double>, double> flows_neighbor; // converged flow vector/waiting time pair of the best neighbor found by the last neighborhood search
 	vector<int> current_vehicles; // number of each vehicle type currently in use
 	int exhaustive_iteration; // iteration of exhaustive local search
+	chrono::steady_clock::time_point checkpoint_time; // time of the last checkpoint (or of the start of the search)
 
 	// Public methods
 	Search(); // constructor initializes network, objective, constraint, and various logger objects
+	Search(Network *); // constructor initializes the objective, constraint, and logger objects for an existing network
 	~Search(); // destructor deletes network, objective, and constraint objects
 	void solve(); // main driver of the solution algorithm
+	void set_bounds(); // determines line and vehicle fleet bounds and current vehicle usage
 	vector<int> make_move(int, int); // returns the results of applying a move to the current solution
 	void vehicle_totals(); // calculates total vehicles of each type in use
 	void save_data(); // writes all current progress to the log files
 	pair<pair<int, int>, double> best_neighbor(); // finds the best move from the current solution via exhaustive neighborhood search
 	void exhaustive_search(); // conducts an exhaustive local search from the current solution
+	void iteration_message(); // queues the current iteration's banner and user cost for the evaluation log
+	void move_message(const pair<int, int> &); // queues a description of a given move for the evaluation log
+	bool write_checkpoint(); // writes the current state of the exhaustive search to the checkpoint file, returning whether it succeeded
+	bool read_checkpoint(); // restores the state of an earlier exhaustive search from the checkpoint file, returning whether there was a usable checkpoint
+	void remove_checkpoint(); // deletes the checkpoint file
 };
@@ -0,0 +1,160 @@
+/// Search checkpoint and interruption methods.
+
+#include "search.hpp"
+
+// Magic number at the beginning of every checkpoint file
+static const char CHECKPOINT_MAGIC[8] = { 'U', 'C', 'C', 'H', 'E', 'C', 'K', '\0' };
+
+// Global interruption flag
+atomic<bool> Interrupted(false);
+
+/// Fixed-size header at the beginning of every checkpoint file.
+struct CheckpointHeader
+{
+	char magic[8]; // magic number
+	uint32_t version; // checkpoint format version
+	uint32_t reserved; // unused padding
+	uint64_t payload_size; // number of bytes following the header
+	uint64_t payload_checksum; // checksum of the bytes following the header
+};
+
+/**
+Signal handler for SIGINT and SIGTERM.
+
+Requires the signal number.
+
+Only sets the interruption flag, which the search checks between candidates and between iterations, since the checkpoint itself cannot safely be written from within a signal handler. A second signal ends the program immediately.
+*/
+void interrupt_search(int signal_number)
+{
+	if (Interrupted == true)
+	{
+		signal(signal_number, SIG_DFL);
+		raise(signal_number);
+		return;
+	}
+	Interrupted = true;
+}
+
+/**
+Writes a checkpoint of the exhaustive search.
+
+Returns true if the checkpoint was written successfully.
+
+The checkpoint holds the current solution, its objective value, the iteration number, and the converged assignment used to warm start its neighbors, along with the size and modification time of every input data file so that it is not used with different data. Evaluated solutions are not included, since the solution log already keeps them on disk.
+
+As with the data snapshot, the checkpoint is first written to a temporary file which then replaces the old checkpoint, so that an interrupted write never leaves a partial checkpoint behind.
+*/
+bool Search::write_checkpoint()
+{
+	// Gather payload
+	string payload;
+	put_array(payload, Net->Input->source_stamps());
+	put_array(payload, vector<int>(1, exhaustive_iteration));
+	put_array(payload, sol_current);
+	put_array(payload, vector<double>({ obj_current, flows_current.second }));
+	put_array(payload, flows_current.first);
+
+	// Fill header
+	CheckpointHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+	header.version = CHECKPOINT_VERSION;
+	header.payload_size = payload.size();
+	header.payload_checksum = checksum(payload.data(), payload.size());
+
+	// Write temporary file and move it into place
+	string checkpoint_name = FILE_BASE + CHECKPOINT_FILE;
+	ofstream checkpoint_file(checkpoint_name + ".tmp", ios_base::binary | ios_base::trunc);
+	if (checkpoint_file.is_open() == false)
+	{
+		Con->Events->message("Failed to write checkpoint.");
+		return false;
+	}
+	checkpoint_file.write((const char *) &header, sizeof(header));
+	checkpoint_file.write(payload.data(), payload.size());
+	checkpoint_file.close();
+	error_code error;
+	filesystem::rename(checkpoint_name + ".tmp", checkpoint_name, error);
+	if ((checkpoint_file.fail() == true) || (error))
+	{
+		Con->Events->message("Failed to write checkpoint.");
+		return false;
+	}
+
+	checkpoint_time = chrono::steady_clock::now();
+	return true;
+}
+
+/**
+Reads the checkpoint of an earlier exhaustive search.
+
+Returns true if a checkpoint was read, in which case the current solution, its objective value and converged assignment, the iteration number, and the vehicle totals are all restored from it. Returns false if there is no checkpoint, or if it is from a different version, is corrupted, or does not match the current input data, in which case nothing is changed.
+*/
+bool Search::read_checkpoint()
+{
+	MappedFile checkpoint;
+	if (checkpoint.open(FILE_BASE + CHECKPOINT_FILE) == false)
+		return false;
+
+	// Check header
+	CheckpointHeader header;
+	if (checkpoint.size < sizeof(header))
+	{
+		Con->Events->message("Checkpoint is incomplete. Starting a new search.");
+		return false;
+	}
+	memcpy(&header, checkpoint.data, sizeof(header));
+	if ((memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) || (header.version != CHECKPOINT_VERSION))
+	{
+		Con->Events->message("Checkpoint is from a different version. Starting a new search.");
+		return false;
+	}
+	const char * payload = checkpoint.data + sizeof(header);
+	size_t size = checkpoint.size - sizeof(header);
+	if ((header.payload_size != size) || (header.payload_checksum != checksum(payload, size)))
+	{
+		Con->Events->message("Checkpoint is corrupted. Starting a new search.");
+		return false;
+	}
+
+	// Read arrays and make sure that they fit the current data
+	vector<int64_t> stamps;
+	vector<int> iteration;
+	vector<int> sol;
+	vector<double> values;
+	vector<double> flows;
+	size_t position = 0;
+	bool complete = get_array(payload, size, position, stamps) && get_array(payload, size, position, iteration) && get_array(payload, size, position, sol)
+		&& get_array(payload, size, position, values) && get_array(payload, size, position, flows);
+	if ((complete == false) || (iteration.size() != 1) || (sol.size() != sol_size) || (values.size() != 2) || (flows.size() != Net->core_arcs.size()))
+	{
+		Con->Events->message("Checkpoint is corrupted. Starting a new search.");
+		return false;
+	}
+	if (stamps != Net->Input->source_stamps())
+	{
+		Con->Events->message("Checkpoint is out of date. Starting a new search.");
+		return false;
+	}
+
+	// Restore search state
+	exhaustive_iteration = iteration[0];
+	sol_current = sol;
+	obj_current = values[0];
+	flows_current.first.swap(flows);
+	flows_current.second = values[1];
+	vehicle_totals();
+
+	ostringstream text;
+	text << "Resuming from checkpoint at iteration " << exhaustive_iteration << '.';
+	Con->Events->message(text.str());
+	return true;
+}
+
+/// Deletes the checkpoint file, if there is one.
+void Search::remove_checkpoint()
+{
+	error_code error;
+	filesystem::remove(FILE_BASE + CHECKPOINT_FILE, error);
+}
@@ -0,0 +1,156 @@
+/// Solution log class methods.
+
+#include "solution_log.hpp"
+
+/**
+Solution log constructor reads the entries of an existing log file and opens the file for appending.
+
+Requires the size of the solution vector and the stamps of the input data files that the logged user cost components depend on. Entries with a different solution size, along with any incomplete final line left by an interrupted run, are ignored.
+
+If the log file does not yet exist, or if its stamp line does not match the given stamps, then a new file is created along with its stamp and header lines. If it cannot be created then the log is kept only in memory.
+*/
+SolutionLog::SolutionLog(int size, const vector<int64_t> &stamps)
+{
+	sol_size = size;
+
+	// Read existing log entries
+	ifstream in_file;
+	in_file.open(FILE_BASE + SOLUTION_LOG_FILE);
+	bool existing = in_file.is_open(); // whether a log file for the current data already exists
+	string line, piece; // whole line and line element being read
+	if (existing == true)
+	{
+		// Compare stamp line to current data
+		getline(in_file, line);
+		stringstream stamp_stream(line);
+		getline(stamp_stream, piece, '\t');
+		vector<int64_t> logged_stamps; // stamps recorded in the log file
+		try
+		{
+			while (getline(stamp_stream, piece, '\t'))
+				logged_stamps.push_back(stoll(piece));
+		}
+		catch (logic_error &e)
+		{
+			logged_stamps.clear();
+		}
+		if (logged_stamps != stamps)
+		{
+			cout << "Solution log is out of date. Starting a new log." << endl;
+			existing = false;
+		}
+		else
+			getline(in_file, line); // skip comment line
+	}
+	if (existing == true)
+	{
+		while (in_file.eof() == false)
+		{
+			// Get whole line as a string stream
+			getline(in_file, line);
+			if (line.size() == 0)
+				// Break for blank line at file end
+				break;
+			stringstream stream(line);
+
+			// Go through each piece of the line
+			string sol;
+			int feas;
+			vector<double> uc(UC_COMPONENTS);
+			double time;
+			try
+			{
+				getline(stream, sol, '\t'); // Solution
+				if (str2vec(sol).size() != sol_size)
+					continue;
+				getline(stream, piece, '\t'); // Feasible
+				feas = stoi(piece);
+				for (int i = 0; i < UC_COMPONENTS; i++)
+				{
+					getline(stream, piece, '\t'); // UC_Riding, UC_Walking, UC_Waiting
+					uc[i] = stod(piece);
+				}
+				if (getline(stream, piece, '\t').fail() == true)
+					// Skip incomplete line
+					continue;
+				time = stod(piece); // Con_Time
+			}
+			catch (logic_error &e)
+			{
+				// Skip malformed line
+				continue;
+			}
+
+			sol_log[sol] = make_tuple(feas, uc, time);
+		}
+
+		cout << "Loaded " << sol_log.size() << " logged solutions." << endl;
+	}
+
+	in_file.close();
+
+	// Open log file for appending, or start a new file with stamp and header lines
+	log_file.open(FILE_BASE + SOLUTION_LOG_FILE, (existing == true) ? ios_base::app : ios_base::trunc);
+	if (log_file.is_open())
+	{
+		if (existing == false)
+		{
+			log_file << "Stamps";
+			for (int i = 0; i < stamps.size(); i++)
+				log_file << '\t' << stamps[i];
+			log_file << endl;
+			log_file << "Solution\tFeasible\tUC_Riding\tUC_Walking\tUC_Waiting\tCon_Time" << endl;
+		}
+		log_file << setprecision(numeric_limits<double>::max_digits10);
+	}
+	else
+		cout << "Failed to open solution log file. Solutions will not be saved." << endl;
+}
+
+/// Solution log destructor closes the log file.
+SolutionLog::~SolutionLog()
+{
+	if (log_file.is_open())
+		log_file.close();
+}
+
+/**
+Looks up a solution in the log.
+
+Requires a solution string and a reference to a vector to hold its user cost components.
+
+Returns true and writes the user cost components if the solution has been logged, and otherwise returns false.
+*/
+bool SolutionLog::lookup(const string &sol, vector<double> &uc)
+{
+	profiled_guard guard(log_lock);
+
+	unordered_map<string, sol_log_tuple>::iterator entry = sol_log.find(sol);
+	if (entry == sol_log.end())
+		return false;
+
+	uc = get<SOL_LOG_UC>(entry->second);
+	return true;
+}
+
+/**
+Adds a solution to the log.
+
+Requires a solution string, its feasibility status, its user cost components, and the time taken to evaluate it.
+
+The entry is written to the log file immediately, so that it survives an interrupted run.
+*/
+void SolutionLog::record(const string &sol, int feas, const vector<double> &uc, double time)
+{
+	profiled_guard guard(log_lock);
+
+	sol_log[sol] = make_tuple(feas, uc, time);
+
+	if (log_file.is_open())
+	{
+		log_file << sol << '\t' << feas;
+		for (int i = 0; i < uc.size(); i++)
+			log_file << '\t' << uc[i];
+		log_file << '\t' << time << endl;
+	}
+}
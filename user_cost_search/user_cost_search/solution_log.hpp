@@ -0,0 +1,58 @@
+/**
+Solution log.
+
+Records the user cost components of every evaluated solution, so that any solution which is encountered again (either later in the same search or in a later search of the same instance) can be looked up rather than re-evaluated.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "instrumentation.hpp"
+
+using namespace std;
+
+extern thread_local string FILE_BASE;
+
+typedef tuple<int, vector<double>, double> sol_log_tuple; // feasibility/user cost component/evaluation time tuple stored for each logged solution (indexed by the SOL_LOG definitions)
+
+// Global function prototypes
+string vec2str(const vector<int> &); // returns string version of integer vector
+vector<int> str2vec(string); // returns an integer vector for a given solution string
+
+// Structure declarations
+struct SolutionLog;
+
+/**
+Solution log class.
+
+Logged solutions are kept in a hash map indexed by solution string. Every new entry is also appended to the solution log file, which is read back in when the log is created, so the log persists between runs. Since the file is only ever appended to, an interrupted run loses at most its final entry.
+
+The user cost components are stored rather than the objective value, so that the log remains valid if the user cost weights are changed. The first line of the file records the size and modification time of every other input data file, and if these no longer match when the log is read (for example because the network or the assignment model parameters have changed) then the existing entries are discarded and a new file is started.
+
+Entries may be looked up and recorded by several threads at once.
+*/
+struct SolutionLog
+{
+	// Public attributes
+	unordered_map<string, sol_log_tuple> sol_log; // logged solutions, indexed by solution string
+	int sol_size; // size of solution vector
+	ofstream log_file; // solution log file, opened for appending
+	mutex log_lock; // lock for the hash map and the log file
+
+	// Public methods
+	SolutionLog(int, const vector<int64_t> &); // constructor reads existing log file entries and opens the file for appending
+	~SolutionLog(); // destructor closes the log file
+	bool lookup(const string &, vector<double> &); // retrieves the user cost components of a logged solution, if present
+	void record(const string &, int, const vector<double> &, double); // adds a solution to the log
+};
@@ -0,0 +1,146 @@
+/// Thread pool class methods.
+
+#include "thread_pool.hpp"
+
+// Worker ID of the current thread (threads outside of the pool act as worker 0)
+static thread_local int worker_id = 0;
+
+/**
+Thread pool constructor launches the requested number of workers.
+
+Requires the total number of workers, with 0 or a negative value selecting one per hardware thread, and the number of workers reserved for outside threads (by default only the thread which owns the pool). At least one and at most every worker is reserved.
+*/
+ThreadPool::ThreadPool(int workers, int callers)
+{
+	if (workers <= 0)
+		workers = thread::hardware_concurrency();
+	if (workers <= 0)
+		workers = 1;
+	worker_count = workers;
+	caller_count = min(max(callers, 1), worker_count);
+
+	queues.resize(worker_count);
+	queue_locks.reset(new mutex[worker_count]);
+	queued = 0;
+
+	// The reserved workers are outside threads, so only the remaining workers need their own threads
+	for (int i = caller_count; i < worker_count; i++)
+		threads.push_back(thread(&ThreadPool::worker_loop, this, i));
+}
+
+/// Thread pool destructor signals all workers to stop and waits for them to exit.
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> guard(sleep_lock);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (int i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+/**
+Executes a batch of tasks and waits for all of them to finish.
+
+Requires the number of tasks and a task function. The task function is called once for each task index in [0, count), along with the ID of the worker executing it.
+
+Tasks are started in ascending order of index wherever possible, so the caller should number its tasks from heaviest to lightest. The calling thread takes part in executing the batch (and any other queued tasks) until the batch is finished.
+*/
+void ThreadPool::run(int count, const function<void(int, int)> &body)
+{
+	if (count <= 0)
+		return;
+
+	int me = worker();
+	atomic<int> remaining(count); // number of unfinished tasks in this batch
+
+	// Deal tasks out in round-robin order, beginning with the calling worker's own queue
+	for (int i = 0; i < worker_count; i++)
+	{
+		int w = (me + i) % worker_count;
+		lock_guard<mutex> guard(queue_locks[w]);
+		for (int j = i; j < count; j += worker_count)
+			queues[w].push_back({ &body, j, &remaining });
+	}
+
+	// Wake idle workers
+	{
+		lock_guard<mutex> guard(sleep_lock);
+		queued += count;
+	}
+	wake.notify_all();
+
+	// Help out until every task of this batch has finished
+	while (remaining.load() > 0)
+		if (execute_one(me) == false)
+			this_thread::yield();
+}
+
+/**
+Executes a single queued task on behalf of a given worker.
+
+Requires the worker ID.
+
+The worker's own queue is checked first, after which the other queues are checked in turn and their front task is stolen. Returns true if a task was executed and false if every queue was empty.
+*/
+bool ThreadPool::execute_one(int me)
+{
+	for (int i = 0; i < worker_count; i++)
+	{
+		int w = (me + i) % worker_count;
+		Task task;
+
+		// Take the front task of the chosen queue, if any
+		{
+			lock_guard<mutex> guard(queue_locks[w]);
+			if (queues[w].empty() == true)
+				continue;
+			task = queues[w].front();
+			queues[w].pop_front();
+		}
+		queued--;
+
+		// Execute task and mark it finished
+		(*task.body)(task.index, me);
+		task.remaining->fetch_sub(1);
+		return true;
+	}
+
+	return false;
+}
+
+/// Main loop of a background worker, which executes queued tasks and sleeps while there are none.
+void ThreadPool::worker_loop(int id)
+{
+	worker_id = id;
+
+	while (true)
+	{
+		if (execute_one(id) == true)
+			continue;
+
+		// Sleep until new tasks are queued or the pool is stopped
+		unique_lock<mutex> guard(sleep_lock);
+		wake.wait(guard, [&] { return (stopping == true) || (queued.load() > 0); });
+		if ((stopping == true) && (queued.load() <= 0))
+			return;
+	}
+}
+
+/// Returns the worker ID of the calling thread.
+int ThreadPool::worker()
+{
+	return worker_id;
+}
+
+/**
+Makes the calling thread act as one of the workers reserved for outside threads.
+
+Requires a worker ID below the number of reserved workers. Since worker IDs index per-worker storage, each reserved ID may only be used by one thread at a time.
+*/
+void ThreadPool::attach(int id)
+{
+	worker_id = id;
+}
@@ -0,0 +1,64 @@
+/**
+Portable work-stealing thread pool.
+
+Used to distribute independent tasks (such as the single-destination subproblems of the constant-cost assignment model) over a fixed set of worker threads. Only the standard library is used, so the pool builds on any platform with C++17 thread support.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Structure declarations
+struct ThreadPool;
+
+extern ThreadPool * Pool;
+
+/**
+Thread pool class.
+
+Each worker owns a double-ended task queue. A batch of tasks submitted through run() is dealt out to the queues in round-robin order, so that every queue is sorted by the caller's priority order. Workers always take the front (highest priority) task of their own queue, and when it runs dry they steal the front task of another worker's queue. Taking the heaviest remaining task first keeps long tasks from being left for the end of a batch.
+
+The thread which calls run() acts as a worker for the duration of the call. A task may itself call run(), in which case the waiting worker helps to execute any queued tasks until its own batch is finished, so nested parallelism never blocks a worker.
+
+Worker IDs are consecutive integers beginning at 0, and can be used by tasks to index per-worker storage. The first IDs are reserved for threads outside of the pool which call run(), and have no background threads of their own. ID 0 is the thread which owns the pool, and any further reserved IDs are taken by other outside threads through attach(), so that several independent callers (such as the instance slots of the batch runner) can share the pool without their work being nested within each other's batches.
+*/
+struct ThreadPool
+{
+	/// A single queued task, consisting of the batch's task function, the task index, and the batch's counter of unfinished tasks.
+	struct Task
+	{
+		const function<void(int, int)> * body; // task function, called with task index and worker ID
+		int index; // task index within its batch
+		atomic<int> * remaining; // number of unfinished tasks in the batch
+	};
+
+	// Public attributes
+	int worker_count; // total number of workers, including the thread which owns the pool
+	int caller_count; // number of workers reserved for threads outside of the pool, including the thread which owns the pool
+	vector<thread> threads; // background worker threads
+	vector<deque<Task>> queues; // task queue of each worker
+	unique_ptr<mutex[]> queue_locks; // lock for each worker's task queue
+	atomic<int> queued; // number of tasks currently waiting in any queue
+	bool stopping = false; // whether the workers have been told to exit
+	mutex sleep_lock; // lock for idle workers waiting on the wake signal
+	condition_variable wake; // signal used to wake idle workers when tasks are queued or the pool is stopping
+
+	// Public methods
+	ThreadPool(int, int = 1); // constructor launches workers (0 for one per hardware thread), reserving a given number of them for outside threads
+	~ThreadPool(); // destructor stops and joins all worker threads
+	void run(int, const function<void(int, int)> &); // executes a batch of tasks in priority order and returns once all have finished
+	bool execute_one(int); // executes a single queued task on behalf of a given worker, if one exists
+	void worker_loop(int); // main loop of a background worker thread
+	static int worker(); // returns the calling thread's worker ID
+	static void attach(int); // makes the calling thread act as a given reserved worker
+};
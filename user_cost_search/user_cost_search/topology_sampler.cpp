@@ -0,0 +1,282 @@
+/// Objective topology sampler methods.
+
+#include "topology_sampler.hpp"
+
+/// Returns a reference to the objective of a given row and column of the slice.
+double &TopologySlice::at(int i, int j)
+{
+	return objective[i*size2 + j];
+}
+
+/**
+Measures the roughness, non-convexity, and non-monotonicity of the objective table.
+
+The objective table should already be filled. Every statistic is 0 for a flat table.
+*/
+void TopologySlice::calculate_statistics()
+{
+	obj_min = *min_element(objective.begin(), objective.end());
+	obj_max = *max_element(objective.begin(), objective.end());
+	roughness = 0.0;
+	nonconvexity = 0.0;
+	nonmonotonicity = 0.0;
+	minima = 0;
+	double range = obj_max - obj_min;
+	if (range <= 0)
+		return;
+
+	// Normalize the table
+	vector<double> z(objective.size());
+	for (int k = 0; k < objective.size(); k++)
+		z[k] = (objective[k] - obj_min) / range;
+
+	// Collect every row (fixed first line fleet) and every column (fixed second line fleet) as a list of table positions
+	vector<vector<int>> sequences;
+	for (int i = 0; i < size1; i++)
+	{
+		vector<int> row;
+		for (int j = 0; j < size2; j++)
+			row.push_back(i*size2 + j);
+		sequences.push_back(row);
+	}
+	for (int j = 0; j < size2; j++)
+	{
+		vector<int> column;
+		for (int i = 0; i < size1; i++)
+			column.push_back(i*size2 + j);
+		sequences.push_back(column);
+	}
+
+	// Second differences and changes of direction along every row and column
+	int second_count = 0; // number of second differences
+	int sequence_count = 0; // number of rows and columns long enough to change direction
+	for (int s = 0; s < sequences.size(); s++)
+	{
+		vector<int> &seq = sequences[s];
+		if (seq.size() < 3)
+			continue;
+		sequence_count++;
+		int direction = 0; // sign of the last difference larger than the tolerance
+		bool turned = false; // whether the objective changes direction along this sequence
+		for (int k = 0; k + 1 < seq.size(); k++)
+		{
+			double difference = z[seq[k + 1]] - z[seq[k]];
+			if (fabs(difference) > TOPOLOGY_TOLERANCE)
+			{
+				int sign = (difference > 0) ? 1 : -1;
+				if ((direction != 0) && (sign != direction))
+					turned = true;
+				direction = sign;
+			}
+			if (k + 2 < seq.size())
+			{
+				double second = z[seq[k + 2]] - 2 * z[seq[k + 1]] + z[seq[k]];
+				roughness += fabs(second);
+				if (second < -TOPOLOGY_TOLERANCE)
+					nonconvexity++;
+				second_count++;
+			}
+		}
+		if (turned == true)
+			nonmonotonicity++;
+	}
+	if (second_count > 0)
+	{
+		roughness /= second_count;
+		nonconvexity /= second_count;
+	}
+	if (sequence_count > 0)
+		nonmonotonicity /= sequence_count;
+
+	// Strict local minima
+	for (int i = 0; i < size1; i++)
+	{
+		for (int j = 0; j < size2; j++)
+		{
+			double value = z[i*size2 + j];
+			if (((i > 0) && (z[(i - 1)*size2 + j] <= value + TOPOLOGY_TOLERANCE)) || ((i + 1 < size1) && (z[(i + 1)*size2 + j] <= value + TOPOLOGY_TOLERANCE))
+				|| ((j > 0) && (z[i*size2 + j - 1] <= value + TOPOLOGY_TOLERANCE)) || ((j + 1 < size2) && (z[i*size2 + j + 1] <= value + TOPOLOGY_TOLERANCE)))
+				continue;
+			minima++;
+		}
+	}
+}
+
+/// Topology sampler constructor sets the search object pointer, the slice radius, and the random seed for choosing line pairs.
+TopologySampler::TopologySampler(Search * solver_in, int radius_in, unsigned int seed)
+{
+	Solver = solver_in;
+	radius = radius_in;
+	generator.seed(seed);
+}
+
+/**
+Samples slices of the objective around the search's current solution.
+
+Requires the number of slices to sample, which is reduced to the number of distinct line pairs if necessary.
+
+The current solution is evaluated first to obtain the assignment used to warm start the center of every slice, after which all slices are evaluated in parallel.
+*/
+void TopologySampler::sample(int count)
+{
+	Solver->set_bounds();
+	int line_count = Solver->sol_size;
+	count = min((long long) count, (long long) line_count * (line_count - 1) / 2);
+
+	// Choose distinct random line pairs
+	slices.clear();
+	set<pair<int, int>> chosen; // line pairs chosen so far, smaller line ID first
+	uniform_int_distribution<int> line_distribution(0, max(0, line_count - 1));
+	while (slices.size() < count)
+	{
+		TopologySlice slice;
+		slice.line1 = line_distribution(generator);
+		slice.line2 = line_distribution(generator);
+		if ((slice.line1 == slice.line2) || (chosen.insert(make_pair(min(slice.line1, slice.line2), max(slice.line1, slice.line2))).second == false))
+			continue;
+		slices.push_back(slice);
+	}
+
+	// Evaluate the current solution
+	pair<vector<double>, double> zero_flows(vector<double>(Solver->Net->core_arcs.size(), 0.0), 0.0);
+	pair<vector<double>, double> flows_center; // converged assignment of the current solution
+	int iterations; // number of Frank-Wolfe iterations of the current solution's assignment
+	Solver->Con->evaluate(Solver->sol_current, zero_flows, flows_center, iterations);
+
+	// Evaluate all slices
+	Pool->run(slices.size(), [&](int task, int worker)
+	{
+		sample_slice(slices[task], flows_center);
+		ostringstream text;
+		text << "\nFinished slice " << task << " (lines " << slices[task].line1 << ',' << slices[task].line2 << ')';
+		Solver->Con->Events->message(text.str());
+	});
+	Solver->Con->Events->flush();
+}
+
+/**
+Evaluates the objective table of a single slice and measures its statistics.
+
+Requires a slice with its line IDs set, and the converged assignment of the current solution.
+
+The center cell is evaluated first, followed by the two halves of the center row in parallel, and then both halves of every column in parallel. Each cell is warm started from its predecessor in its chain.
+*/
+void TopologySampler::sample_slice(TopologySlice &slice, const pair<vector<double>, double> &flows_center)
+{
+	// Find each line's range of fleet sizes, centered on its current fleet size clamped to its bounds
+	int center1 = min(max(Solver->sol_current[slice.line1], Solver->line_min[slice.line1]), Solver->line_max[slice.line1]);
+	int center2 = min(max(Solver->sol_current[slice.line2], Solver->line_min[slice.line2]), Solver->line_max[slice.line2]);
+	slice.lb1 = max(Solver->line_min[slice.line1], center1 - radius);
+	slice.lb2 = max(Solver->line_min[slice.line2], center2 - radius);
+	slice.size1 = min(Solver->line_max[slice.line1], center1 + radius) - slice.lb1 + 1;
+	slice.size2 = min(Solver->line_max[slice.line2], center2 + radius) - slice.lb2 + 1;
+	slice.objective.assign(slice.size1 * slice.size2, INFINITY);
+	int i0 = center1 - slice.lb1; // row of the center cell
+	int j0 = center2 - slice.lb2; // column of the center cell
+	vector<pair<vector<double>, double>> flows_row(slice.size2); // warm start left for each column by its cell in the center row
+
+	// Evaluates a single cell, and replaces the warm start with the cell's converged assignment if one was found
+	auto evaluate_cell = [&](int i, int j, pair<vector<double>, double> &warm_start)
+	{
+		vector<int> sol = Solver->sol_current;
+		sol[slice.line1] = slice.lb1 + i;
+		sol[slice.line2] = slice.lb2 + j;
+		pair<vector<double>, double> flows; // converged assignment of the cell
+		slice.at(i, j) = Solver->Con->calculate(sol, warm_start, flows);
+		if (flows.first.empty() == false)
+			warm_start.swap(flows);
+	};
+
+	// Center cell
+	flows_row[j0] = flows_center;
+	evaluate_cell(i0, j0, flows_row[j0]);
+
+	// Both halves of the center row, each leaving its converged assignments for the columns
+	Pool->run(2, [&](int task, int worker)
+	{
+		int step = (task == 0) ? -1 : 1;
+		for (int j = j0 + step; (j >= 0) && (j < slice.size2); j += step)
+		{
+			flows_row[j] = flows_row[j - step];
+			evaluate_cell(i0, j, flows_row[j]);
+		}
+	});
+
+	// Both halves of every column
+	Pool->run(2 * slice.size2, [&](int task, int worker)
+	{
+		int j = task / 2;
+		int step = (task % 2 == 0) ? -1 : 1;
+		pair<vector<double>, double> warm_start = flows_row[j];
+		for (int i = i0 + step; (i >= 0) && (i < slice.size1); i += step)
+			evaluate_cell(i, j, warm_start);
+	});
+
+	slice.calculate_statistics();
+}
+
+/**
+Writes the sampled objective tables and slice statistics to the log folder.
+
+Returns true if both files were written successfully.
+*/
+bool TopologySampler::write()
+{
+	ofstream table_file(FILE_BASE + TOPOLOGY_TABLE_FILE);
+	ofstream summary_file(FILE_BASE + TOPOLOGY_SUMMARY_FILE);
+	if ((table_file.is_open() == false) || (summary_file.is_open() == false))
+	{
+		cout << "Failed to write objective topology." << endl;
+		return false;
+	}
+
+	table_file << "Slice\tLine1\tLine2\tFleet1\tFleet2\tObjective\n";
+	table_file << fixed << setprecision(15);
+	summary_file << "Slice\tLine1\tLine2\tFleet1_Min\tFleet1_Max\tFleet2_Min\tFleet2_Max\tObjective_Min\tObjective_Max\tRoughness\tNonconvexity\tNonmonotonicity\tMinima\n";
+	summary_file << fixed << setprecision(15);
+	for (int s = 0; s < slices.size(); s++)
+	{
+		TopologySlice &slice = slices[s];
+		for (int i = 0; i < slice.size1; i++)
+			for (int j = 0; j < slice.size2; j++)
+				table_file << s << '\t' << slice.line1 << '\t' << slice.line2 << '\t' << slice.lb1 + i << '\t' << slice.lb2 + j << '\t' << slice.at(i, j) << '\n';
+		summary_file << s << '\t' << slice.line1 << '\t' << slice.line2 << '\t' << slice.lb1 << '\t' << slice.lb1 + slice.size1 - 1 << '\t' << slice.lb2 << '\t' << slice.lb2 + slice.size2 - 1 << '\t';
+		summary_file << slice.obj_min << '\t' << slice.obj_max << '\t' << slice.roughness << '\t' << slice.nonconvexity << '\t' << slice.nonmonotonicity << '\t' << slice.minima << '\n';
+	}
+	table_file.close();
+	summary_file.close();
+
+	if ((table_file.fail() == true) || (summary_file.fail() == true))
+	{
+		cout << "Failed to write objective topology." << endl;
+		return false;
+	}
+	return true;
+}
+
+/// Prints the statistics of every slice, followed by their averages and the number of slices with more than one local minimum.
+void TopologySampler::report()
+{
+	double roughness = 0.0, nonconvexity = 0.0, nonmonotonicity = 0.0;
+	int multiple = 0; // number of slices with more than one local minimum
+
+	cout << "\n============================================================" << endl;
+	cout << "Objective topology" << endl;
+	cout << "============================================================" << endl << endl;
+	cout << "Lines\tRange\tRoughness\tNonconvexity\tNonmonotonicity\tMinima" << endl;
+	for (int s = 0; s < slices.size(); s++)
+	{
+		TopologySlice &slice = slices[s];
+		cout << slice.line1 << ',' << slice.line2 << '\t' << slice.obj_max - slice.obj_min << '\t' << slice.roughness << '\t' << slice.nonconvexity << '\t' << slice.nonmonotonicity << '\t' << slice.minima << endl;
+		roughness += slice.roughness / slices.size();
+		nonconvexity += slice.nonconvexity / slices.size();
+		nonmonotonicity += slice.nonmonotonicity / slices.size();
+		if (slice.minima > 1)
+			multiple++;
+	}
+
+	cout << "\nMean roughness: " << roughness << endl;
+	cout << "Mean nonconvexity: " << nonconvexity << endl;
+	cout << "Mean nonmonotonicity: " << nonmonotonicity << endl;
+	cout << "Slices with multiple local minima: " << multiple << '/' << slices.size() << endl;
+}
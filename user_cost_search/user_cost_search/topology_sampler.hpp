@@ -0,0 +1,91 @@
+/**
+Objective topology sampler.
+
+A native version of the "Objective Topology" section of the social-transit-ex.nb notebook, which judges whether an instance is interesting by tabulating the objective (the user cost) over two-dimensional slices of the solution space. Each slice varies the fleet sizes of a random pair of lines within a range around the initial solution while leaving all other lines fixed. An interesting instance should show rough, non-monotonic, and non-convex slices, and the sampler summarizes each slice with statistics measuring these properties so that many generated instances can be screened without drawing their tables.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "constraints.hpp"
+#include "search.hpp"
+#include "thread_pool.hpp"
+
+#define TOPOLOGY_TABLE_FILE "log/topology_tables.txt" // objective value of every sampled solution
+#define TOPOLOGY_SUMMARY_FILE "log/topology_summary.txt" // statistics of every sampled slice
+#define TOPOLOGY_TOLERANCE 0.0001 // fraction of a slice's objective range below which differences are treated as noise
+
+using namespace std;
+
+extern thread_local string FILE_BASE;
+
+// Structure declarations
+struct TopologySlice;
+struct TopologySampler;
+
+/**
+A single two-dimensional slice of the objective.
+
+The objective table is stored row by row, with the rows corresponding to the first line's fleet sizes and the columns to the second line's fleet sizes, both in ascending order.
+
+All statistics are measured on the objective table after normalizing it to the interval [0,1], as in the notebook's plots, so that they can be compared between slices and between instances. Differences smaller than the tolerance are treated as assignment model noise.
+	roughness: mean absolute second difference along the rows and columns
+	nonconvexity: fraction of second differences along the rows and columns which are negative
+	nonmonotonicity: fraction of rows and columns along which the objective changes direction
+	minima: number of strict local minima (cells lower than all of their horizontal and vertical neighbors)
+*/
+struct TopologySlice
+{
+	// Public attributes
+	int line1 = 0; // ID of the line varied along the rows
+	int line2 = 0; // ID of the line varied along the columns
+	int lb1 = 0; // smallest fleet size of the first line
+	int lb2 = 0; // smallest fleet size of the second line
+	int size1 = 0; // number of fleet sizes of the first line
+	int size2 = 0; // number of fleet sizes of the second line
+	vector<double> objective; // objective table, row by row
+	double obj_min = 0.0; // smallest objective value
+	double obj_max = 0.0; // largest objective value
+	double roughness = 0.0; // mean absolute normalized second difference
+	double nonconvexity = 0.0; // fraction of negative second differences
+	double nonmonotonicity = 0.0; // fraction of non-monotonic rows and columns
+	int minima = 0; // number of strict local minima
+
+	// Public methods
+	double &at(int, int); // returns a reference to the objective of a given row and column
+	void calculate_statistics(); // measures the roughness, non-convexity, and non-monotonicity of the objective table
+};
+
+/**
+Objective topology sampler class.
+
+Slices are centered on the search's current solution, clamped to the line fleet bounds, and extend up to a given radius in each direction without leaving the bounds.
+
+Every objective value comes from Constraint::calculate(), so sampled solutions are shared with the solution log. Each cell's assignment model is warm started from the converged assignment of a neighboring cell. The center cell of each slice is warm started from the converged assignment of the current solution, the cells of the center row are then evaluated outward from the center, and finally each column is evaluated outward from the center row. The two halves of the center row, and the two halves of every column, form separate chains which are evaluated in parallel, as are the slices themselves. A cell whose objective is found in the solution log has no converged assignment, so the next cell in its chain is warm started from the same assignment that it would have been.
+*/
+struct TopologySampler
+{
+	// Public attributes
+	Search * Solver; // pointer to the search object whose current solution and bounds are used
+	int radius; // largest change to either line's fleet size within a slice
+	mt19937 generator; // random number generator used to choose line pairs
+	vector<TopologySlice> slices; // sampled slices
+
+	// Public methods
+	TopologySampler(Search *, int, unsigned int); // constructor sets the search object pointer, slice radius, and random seed
+	void sample(int); // chooses a given number of distinct random line pairs and evaluates their slices
+	void sample_slice(TopologySlice &, const pair<vector<double>, double> &); // evaluates a single slice, warm starting its center from a given assignment
+	bool write(); // writes the objective tables and slice statistics to the log folder, returning whether both were written
+	void report(); // prints the statistics of every slice and their averages
+};
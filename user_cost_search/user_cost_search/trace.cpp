@@ -0,0 +1,120 @@
+/// Trace recorder class methods.
+
+#include "trace.hpp"
+
+// Global trace recorder
+Tracer Trace;
+
+/// Trace buffer constructor allocates the ring and marks it empty.
+TraceBuffer::TraceBuffer()
+{
+	events.resize(TRACE_BUFFER_SIZE);
+	count = 0;
+}
+
+/// Trace recorder destructor deletes all ring buffers.
+Tracer::~Tracer()
+{
+	for (int i = 0; i < buffers.size(); i++)
+		delete buffers[i];
+}
+
+/**
+Discards all recorded events and creates an empty ring buffer for each worker.
+
+Requires the number of workers in the thread pool.
+
+Event times are measured from the time of this call.
+*/
+void Tracer::start(int workers)
+{
+	for (int i = 0; i < buffers.size(); i++)
+		delete buffers[i];
+	buffers.clear();
+	for (int i = 0; i < workers; i++)
+		buffers.push_back(new TraceBuffer());
+	origin = chrono::steady_clock::now();
+}
+
+/**
+Records an event of the calling worker.
+
+Requires the event name, its argument, and its phase ('B' or 'E').
+
+The event is written into the next slot of the worker's ring, overwriting the oldest event if the ring is full, and only then is the event count advanced, so a reader which sees the new count also sees the whole event.
+*/
+void Tracer::event(const char * name, int arg, char phase)
+{
+	TraceBuffer * buffer = buffers[ThreadPool::worker()];
+	uint64_t position = buffer->count.load(memory_order_relaxed);
+	TraceEvent &slot = buffer->events[position % TRACE_BUFFER_SIZE];
+	slot.name = name;
+	slot.time = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count();
+	slot.arg = arg;
+	slot.phase = phase;
+	buffer->count.store(position + 1, memory_order_release);
+}
+
+/**
+Writes all recorded events to the trace file in Chrome trace-event JSON format.
+
+Returns true if the file was written successfully.
+
+Each worker appears as a separate thread of the timeline. If a worker's ring has overflowed then its oldest surviving events may include end events whose begin events were overwritten, and these are left out so that every span in the file is complete.
+*/
+bool Tracer::write()
+{
+	ofstream trace_file(FILE_BASE + TRACE_FILE);
+	if (trace_file.is_open() == false)
+	{
+		cout << "Failed to write trace." << endl;
+		return false;
+	}
+
+	trace_file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	trace_file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"user_cost_search\"}}";
+	for (int w = 0; w < buffers.size(); w++)
+	{
+		trace_file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << w << ",\"args\":{\"name\":\"worker " << w << "\"}}";
+
+		// Replay the surviving events in order, skipping end events whose begin events were lost
+		uint64_t count = buffers[w]->count.load(memory_order_acquire);
+		uint64_t first = (count > TRACE_BUFFER_SIZE) ? count - TRACE_BUFFER_SIZE : 0;
+		int depth = 0; // number of open spans
+		for (uint64_t i = first; i < count; i++)
+		{
+			const TraceEvent &event = buffers[w]->events[i % TRACE_BUFFER_SIZE];
+			if (event.phase == 'B')
+				depth++;
+			else if (depth > 0)
+				depth--;
+			else
+				continue;
+			trace_file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"pid\":0,\"tid\":" << w << ",\"ts\":" << event.time / 1000 << '.';
+			trace_file << (event.time % 1000) / 100 << (event.time % 100) / 10 << event.time % 10 << ",\"args\":{\"id\":" << event.arg << "}}";
+		}
+	}
+	trace_file << "\n]}" << endl;
+	trace_file.close();
+
+	if (trace_file.fail() == true)
+	{
+		cout << "Failed to write trace." << endl;
+		return false;
+	}
+	return true;
+}
+
+/// Trace span constructor records a begin event for the calling worker.
+TraceScope::TraceScope(const char * name_in, int arg_in)
+{
+	name = name_in;
+	arg = arg_in;
+	Trace.event(name, arg, 'B');
+}
+
+/// Trace span destructor records the matching end event for the calling worker.
+TraceScope::~TraceScope()
+{
+	Trace.event(name, arg, 'E');
+}
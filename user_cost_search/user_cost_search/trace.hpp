@@ -0,0 +1,98 @@
+/**
+Timeline trace recorder.
+
+Records when each worker thread begins and ends every single-destination task of the constant-cost model, every Frank-Wolfe iteration of the nonlinear model, and every candidate of the neighborhood search, and writes them as a Chrome trace-event JSON file which can be opened in a timeline viewer (such as chrome://tracing or Perfetto). Idle gaps between tasks and stragglers at the ends of parallel batches show up directly on the timeline.
+
+Tracing is selected at compile time by the TRACE definition. When it is 0 the TRACE_* macros defined at the end of this file expand to nothing.
+
+Each worker owns a fixed-size ring buffer which only it writes, so recording an event requires no locks. When a buffer fills up its oldest events are overwritten, so the trace always covers the end of the run. The buffers are only read when the trace is written, which must happen after all tasks have finished.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "thread_pool.hpp"
+
+#define TRACE_FILE "log/trace.json" // trace output file
+#define TRACE_BUFFER_SIZE 262144 // number of events kept by each worker (24 bytes each)
+
+using namespace std;
+
+extern thread_local string FILE_BASE;
+
+// Structure declarations
+struct TraceEvent;
+struct TraceBuffer;
+struct Tracer;
+struct TraceScope;
+
+extern Tracer Trace;
+
+/// A single begin or end event.
+struct TraceEvent
+{
+	// Public attributes
+	const char * name; // event name (a string literal)
+	int64_t time; // nanoseconds since the trace started
+	int arg; // event argument, such as a destination or an iteration number
+	char phase; // 'B' for a begin event and 'E' for an end event
+};
+
+/// Ring buffer of events owned by a single worker.
+struct alignas(64) TraceBuffer
+{
+	// Public attributes
+	vector<TraceEvent> events; // ring of the most recent events
+	atomic<uint64_t> count; // total number of events ever recorded
+
+	// Public methods
+	TraceBuffer(); // constructor allocates the ring
+};
+
+/**
+Trace recorder class.
+
+Holds one ring buffer for each worker of the thread pool.
+*/
+struct Tracer
+{
+	// Public attributes
+	vector<TraceBuffer *> buffers; // ring buffer of each worker
+	chrono::steady_clock::time_point origin; // time at which the trace started
+
+	// Public methods
+	~Tracer(); // destructor deletes all buffers
+	void start(int); // discards all events and creates a ring buffer for each of a given number of workers
+	void event(const char *, int, char); // records an event of the calling worker
+	bool write(); // writes all recorded events to the trace file, returning whether it was written
+};
+
+/// Scoped trace span, which records a begin event when created and the matching end event when destroyed.
+struct TraceScope
+{
+	// Public attributes
+	const char * name; // event name
+	int arg; // event argument
+
+	// Public methods
+	TraceScope(const char *, int); // constructor records the begin event
+	~TraceScope(); // destructor records the end event
+};
+
+// Trace macros
+#if TRACE == 1
+#define TRACE_START(workers) Trace.start(workers) // discards all events and sizes the buffers for a given number of workers
+#define TRACE_SCOPE(variable, name, arg) TraceScope variable(name, arg) // records a span covering the rest of the enclosing scope
+#define TRACE_WRITE() Trace.write() // writes the trace file
+#else
+#define TRACE_START(workers)
+#define TRACE_SCOPE(variable, name, arg)
+#define TRACE_WRITE()
+#endif
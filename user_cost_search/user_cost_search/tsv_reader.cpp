@@ -0,0 +1,185 @@
+/// Tab-separated file reader class methods.
+
+#include "tsv_reader.hpp"
+
+/**
+Reads columns of a tab-separated file.
+
+Requires the file name and a list of the columns to read.
+
+Returns true if every row was read successfully, in which case the values of each column are appended to its destination vector in file order. Otherwise returns false, leaves the destination vectors unchanged, and stores a description of the problem in the error attribute.
+
+The header line is skipped. Files larger than a single chunk are divided into roughly equal chunks, each of which begins at the start of a line, and the chunks are parsed in parallel if the thread pool exists.
+*/
+bool TsvReader::read(const string &file_name, const vector<TsvColumn> &columns)
+{
+	MappedFile file;
+	if (file.open(file_name) == false)
+	{
+		error = file_name + " failed to open.";
+		return false;
+	}
+
+	// Skip header line
+	const char * end = file.data + file.size;
+	const char * body = end;
+	if (file.size > 0)
+	{
+		const char * newline = (const char *) memchr(file.data, '\n', file.size);
+		if (newline != nullptr)
+			body = newline + 1;
+	}
+
+	// Divide the body into chunks which begin at line boundaries
+	size_t body_size = end - body;
+	int chunk_count = 1;
+	if (Pool != nullptr)
+		chunk_count = max(1, (int) min((size_t) Pool->worker_count * TSV_CHUNKS_PER_WORKER, body_size / TSV_MIN_CHUNK));
+	vector<Chunk> chunks(chunk_count);
+	const char * position = body;
+	for (int i = 0; i < chunk_count; i++)
+	{
+		chunks[i].begin = position;
+		if (i == chunk_count - 1)
+			position = end;
+		else
+		{
+			// Advance to the end of the line containing the chunk's nominal end
+			const char * target = max(position, body + body_size * (i + 1) / chunk_count);
+			const char * newline = (const char *) memchr(target, '\n', end - target);
+			position = (newline == nullptr) ? end : newline + 1;
+		}
+		chunks[i].end = position;
+	}
+
+	// Parse all chunks
+	if (chunk_count == 1)
+		parse_chunk(chunks[0], columns);
+	else
+		Pool->run(chunk_count, [&](int task, int worker)
+		{
+			parse_chunk(chunks[task], columns);
+		});
+
+	// Report the first malformed row, numbering lines from 1 beginning with the header
+	int line = 1;
+	for (int i = 0; i < chunk_count; i++)
+	{
+		if (chunks[i].error_line > 0)
+		{
+			error = file_name + " line " + to_string(line + chunks[i].error_line) + ": " + chunks[i].error;
+			return false;
+		}
+		line += chunks[i].lines;
+	}
+
+	// Join chunks in file order
+	for (int k = 0; k < columns.size(); k++)
+	{
+		size_t total = 0;
+		for (int i = 0; i < chunk_count; i++)
+			total += (columns[k].ints != nullptr) ? chunks[i].ints[k].size() : chunks[i].doubles[k].size();
+
+		if (columns[k].ints != nullptr)
+		{
+			columns[k].ints->reserve(columns[k].ints->size() + total);
+			for (int i = 0; i < chunk_count; i++)
+				columns[k].ints->insert(columns[k].ints->end(), chunks[i].ints[k].begin(), chunks[i].ints[k].end());
+		}
+		else
+		{
+			columns[k].doubles->reserve(columns[k].doubles->size() + total);
+			for (int i = 0; i < chunk_count; i++)
+				columns[k].doubles->insert(columns[k].doubles->end(), chunks[i].doubles[k].begin(), chunks[i].doubles[k].end());
+		}
+	}
+
+	return true;
+}
+
+/**
+Parses every row of a single chunk.
+
+Requires a reference to the chunk and the list of columns to read.
+
+Fills the chunk's value vectors and line count. Parsing stops at the first malformed row, whose line number within the chunk and description are recorded in the chunk.
+*/
+void TsvReader::parse_chunk(Chunk &chunk, const vector<TsvColumn> &columns)
+{
+	chunk.ints.resize(columns.size());
+	chunk.doubles.resize(columns.size());
+
+	// Find the column read from each field position
+	int field_count = 0;
+	for (int k = 0; k < columns.size(); k++)
+		field_count = max(field_count, columns[k].field + 1);
+	vector<int> field_column(field_count, NO_ID);
+	for (int k = 0; k < columns.size(); k++)
+		field_column[columns[k].field] = k;
+
+	const char * position = chunk.begin;
+	while (position < chunk.end)
+	{
+		// Find the end of the line, ignoring any carriage return
+		const char * line_end = (const char *) memchr(position, '\n', chunk.end - position);
+		if (line_end == nullptr)
+			line_end = chunk.end;
+		const char * row_end = line_end;
+		if ((row_end > position) && (*(row_end - 1) == '\r'))
+			row_end--;
+		chunk.lines++;
+
+		// Skip blank lines
+		if (row_end == position)
+		{
+			position = line_end + 1;
+			continue;
+		}
+
+		// Go through each field of the row up to the last one needed
+		const char * field_begin = position;
+		for (int f = 0; f < field_count; f++)
+		{
+			int k = field_column[f];
+			if (field_begin > row_end)
+			{
+				chunk.error_line = chunk.lines;
+				chunk.error = "row has only " + to_string(f) + " fields";
+				if (k != NO_ID)
+					chunk.error += " (missing " + columns[k].name + ")";
+				return;
+			}
+			const char * field_end = (const char *) memchr(field_begin, '\t', row_end - field_begin);
+			if (field_end == nullptr)
+				field_end = row_end;
+
+			// Convert the field if it belongs to a requested column
+			if (k != NO_ID)
+			{
+				from_chars_result result;
+				if (columns[k].ints != nullptr)
+				{
+					int value;
+					result = from_chars(field_begin, field_end, value);
+					chunk.ints[k].push_back(value);
+				}
+				else
+				{
+					double value;
+					result = from_chars(field_begin, field_end, value);
+					chunk.doubles[k].push_back(value);
+				}
+				if ((result.ec != errc()) || (result.ptr != field_end))
+				{
+					chunk.error_line = chunk.lines;
+					chunk.error = "could not read " + columns[k].name + " value \"" + string(field_begin, field_end) + "\"";
+					return;
+				}
+			}
+
+			field_begin = field_end + 1;
+		}
+
+		position = line_end + 1;
+	}
+}
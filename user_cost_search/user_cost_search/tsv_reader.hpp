@@ -0,0 +1,58 @@
+/**
+Reader for the tab-separated input data files.
+
+Every input data file consists of a header line followed by rows of tab-separated fields. The reader maps a file into memory and converts the requested fields of every row directly from the mapped text with from_chars, without creating any intermediate strings. Large files are split into chunks at line boundaries which are parsed in parallel on the thread pool and then joined in file order.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "DEFINITIONS.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+
+using namespace std;
+
+// Structure declarations
+struct TsvColumn;
+struct TsvReader;
+
+/// A single column to be read from a tab-separated file, consisting of the field's position within each row, its name for use in error messages, and exactly one of an integer and a floating point destination vector.
+struct TsvColumn
+{
+	int field; // position of the field within each row, beginning at 0
+	string name; // name of the column
+	vector<int> * ints; // destination of an integer column (null for a floating point column)
+	vector<double> * doubles; // destination of a floating point column (null for an integer column)
+};
+
+/**
+Tab-separated file reader class.
+
+Rows are read until the end of the file, skipping blank lines. A row which is missing a requested field or whose field cannot be converted in full to the requested type is reported along with its line number, and causes the whole file to be rejected.
+*/
+struct TsvReader
+{
+	/// Parsed contents of a single chunk of a file.
+	struct Chunk
+	{
+		const char * begin; // first character of the chunk
+		const char * end; // one past the last character of the chunk
+		vector<vector<int>> ints; // parsed values of each integer column
+		vector<vector<double>> doubles; // parsed values of each floating point column
+		int lines = 0; // number of lines in the chunk
+		int error_line = 0; // line within the chunk of the first malformed row (0 if none)
+		string error; // description of the first malformed row
+	};
+
+	// Public attributes
+	string error; // description of the most recent failure, including the file name and line number
+
+	// Public methods
+	bool read(const string &, const vector<TsvColumn> &); // reads the given columns of a file into their destination vectors, returning whether it succeeded
+	void parse_chunk(Chunk &, const vector<TsvColumn> &); // parses every row of a single chunk
+};